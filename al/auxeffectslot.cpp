@@ -314,6 +314,39 @@ inline void UpdateProps(ALeffectslot *slot, ALCcontext *context)
     slot->mPropsDirty = true;
 }
 
+/* Takes the slot off its device bus, giving the bus up if the slot owns it.
+ * Voices in other contexts may send to the slot's mixing buffer until the
+ * mixer sees the change, so the caller must wait for the mix before freeing
+ * the slot.
+ */
+void LeaveDeviceBus(ALeffectslot *slot, DeviceBase *device) noexcept
+{
+    if(slot->DeviceBus == 0)
+        return;
+
+    EffectSlot *owner{slot->mSlot};
+    device->mBusSlots[slot->DeviceBus-1].compare_exchange_strong(owner, nullptr,
+        std::memory_order_acq_rel, std::memory_order_relaxed);
+    slot->DeviceBus = 0;
+}
+
+auto IsEffectSlotTarget(ALCcontext *context, const ALeffectslot *target) noexcept -> bool
+{
+    return std::any_of(context->mEffectSlotList.cbegin(), context->mEffectSlotList.cend(),
+        [target](const EffectSlotSubList &sublist) noexcept -> bool
+    {
+        uint64_t usemask{~sublist.FreeMask};
+        while(usemask)
+        {
+            const auto idx = static_cast<uint>(al::countr_zero(usemask));
+            usemask &= ~(1_u64 << idx);
+            if((*sublist.EffectSlots)[idx].Target == target)
+                return true;
+        }
+        return false;
+    });
+}
+
 } // namespace
 
 
@@ -385,6 +418,7 @@ try {
             throw al::context_error{AL_INVALID_OPERATION, "Deleting in-use effect slot %u",
                 *effectslots};
 
+        LeaveDeviceBus(slot, context->mDevice);
         RemoveActiveEffectSlots({&slot, 1u}, context);
         FreeEffectSlot(context, slot);
     }
@@ -407,6 +441,8 @@ try {
         std::transform(eids.cbegin(), eids.cend(), std::back_inserter(slots), lookupslot);
 
         /* All effectslots are valid, remove and delete them */
+        for(ALeffectslot *slot : slots)
+            LeaveDeviceBus(slot, context->mDevice);
         RemoveActiveEffectSlots(slots, context);
 
         auto delete_effectslot = [context](const ALuint eid) -> void
@@ -526,6 +562,9 @@ try {
             throw al::context_error{AL_INVALID_VALUE, "Invalid effect slot target ID"};
         if(slot->Target == target) UNLIKELY
             return;
+        if(target && (slot->DeviceBus != 0 || target->DeviceBus != 0))
+            throw al::context_error{AL_INVALID_OPERATION,
+                "Effect slot ID %u or its target %u is on a device bus", slot->id, target->id};
         if(target)
         {
             ALeffectslot *checker{target};
@@ -554,6 +593,41 @@ try {
         UpdateProps(slot, context);
         return;
 
+    case AL_EFFECTSLOT_DEVICE_BUS_SOFT:
+        if(!(value >= 0 && static_cast<uint>(value) <= MaxDeviceBuses))
+            throw al::context_error{AL_INVALID_VALUE, "Effect slot device bus %d out of range",
+                value};
+        if(slot->DeviceBus == static_cast<ALuint>(value)) UNLIKELY
+            return;
+        if(value != 0 && (slot->Target || IsEffectSlotTarget(context, slot)))
+            throw al::context_error{AL_INVALID_OPERATION,
+                "Effect slot ID %u has or is an effect slot target", slot->id};
+
+        /* The first slot on a bus owns it. */
+        LeaveDeviceBus(slot, context->mDevice);
+        if(value != 0)
+        {
+            EffectSlot *owner{nullptr};
+            context->mDevice->mBusSlots[static_cast<uint>(value)-1].compare_exchange_strong(owner,
+                slot->mSlot, std::memory_order_acq_rel, std::memory_order_relaxed);
+            slot->DeviceBus = static_cast<ALuint>(value);
+        }
+
+        /* A slot without an effect can still send to the bus, so it needs to
+         * be playing for the mixer to know about it.
+         */
+        if(slot->mState == SlotState::Initial) UNLIKELY
+        {
+            slot->mPropsDirty = false;
+            slot->updateProps(context);
+
+            AddActiveEffectSlots({&slot, 1}, context);
+            slot->mState = SlotState::Playing;
+            return;
+        }
+        UpdateProps(slot, context);
+        return;
+
     case AL_BUFFER:
         if(ALbuffer *buffer{slot->Buffer})
         {
@@ -652,6 +726,7 @@ try {
     case AL_EFFECTSLOT_AUXILIARY_SEND_AUTO:
     case AL_EFFECTSLOT_TARGET_SOFT:
     case AL_EFFECTSLOT_STATE_SOFT:
+    case AL_EFFECTSLOT_DEVICE_BUS_SOFT:
     case AL_BUFFER:
         alAuxiliaryEffectSlotiDirect(context, effectslot, param, *values);
         return;
@@ -759,6 +834,10 @@ try {
         *value = static_cast<int>(slot->mState);
         return;
 
+    case AL_EFFECTSLOT_DEVICE_BUS_SOFT:
+        *value = static_cast<ALint>(slot->DeviceBus);
+        return;
+
     case AL_BUFFER:
         if(auto *buffer = slot->Buffer)
             *value = static_cast<ALint>(buffer->id);
@@ -783,6 +862,7 @@ try {
     case AL_EFFECTSLOT_AUXILIARY_SEND_AUTO:
     case AL_EFFECTSLOT_TARGET_SOFT:
     case AL_EFFECTSLOT_STATE_SOFT:
+    case AL_EFFECTSLOT_DEVICE_BUS_SOFT:
     case AL_BUFFER:
         alGetAuxiliaryEffectSlotiDirect(context, effectslot, param, values);
         return;
@@ -925,22 +1005,39 @@ ALenum ALeffectslot::initEffect(ALuint effectId, ALenum effectType, const Effect
 void ALeffectslot::updateProps(ALCcontext *context) const
 {
     /* Get an unused property container, or allocate a new one as needed. */
-    EffectSlotProps *props{context->mFreeEffectSlotProps.load(std::memory_order_acquire)};
-    if(!props)
+    auto get_props = [this,context]() -> EffectSlotProps*
     {
-        context->allocEffectSlotProps();
-        props = context->mFreeEffectSlotProps.load(std::memory_order_acquire);
-    }
-    EffectSlotProps *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(!context->mFreeEffectSlotProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire));
+        EffectSlotProps *props{context->mFreeEffectSlotProps.load(std::memory_order_acquire)};
+        if(!props) UNLIKELY
+        {
+            /* Fixed pools overwrite the slot's pending update, if it has one,
+             * rather than allocating more.
+             */
+            if(context->mFixedPools)
+            {
+                if(auto *pending = mSlot->Update.exchange(nullptr, std::memory_order_acq_rel))
+                    return pending;
+                context->mEffectSlotPropsUsage.mExhausted.fetch_add(1u,
+                    std::memory_order_relaxed);
+            }
+            context->allocEffectSlotProps();
+            props = context->mFreeEffectSlotProps.load(std::memory_order_acquire);
+        }
+        EffectSlotProps *next;
+        do {
+            next = props->next.load(std::memory_order_relaxed);
+        } while(!context->mFreeEffectSlotProps.compare_exchange_weak(props, next,
+            std::memory_order_acq_rel, std::memory_order_acquire));
+        context->mEffectSlotPropsUsage.take();
+        return props;
+    };
+    EffectSlotProps *props{get_props()};
 
     /* Copy in current property values. */
     props->Gain = Gain;
     props->AuxSendAuto = AuxSendAuto;
     props->Target = Target ? Target->mSlot : nullptr;
+    props->DeviceBus = DeviceBus;
 
     props->Type = Effect.Type;
     props->Props = Effect.Props;
@@ -955,6 +1052,7 @@ void ALeffectslot::updateProps(ALCcontext *context) const
          */
         props->State = nullptr;
         AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+        context->mEffectSlotPropsUsage.give();
     }
 }
 
@@ -987,6 +1085,21 @@ void UpdateAllEffectSlotProps(ALCcontext *context)
     }
 }
 
+void LeaveAllDeviceBuses(ALCcontext *context)
+{
+    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    for(auto &sublist : context->mEffectSlotList)
+    {
+        uint64_t usemask{~sublist.FreeMask};
+        while(usemask)
+        {
+            const auto idx = static_cast<uint>(al::countr_zero(usemask));
+            usemask &= ~(1_u64 << idx);
+            LeaveDeviceBus(&(*sublist.EffectSlots)[idx], context->mDevice);
+        }
+    }
+}
+
 EffectSlotSubList::~EffectSlotSubList()
 {
     if(!EffectSlots)
@@ -47,6 +47,7 @@ struct ALeffectslot {
     bool  AuxSendAuto{true};
     ALeffectslot *Target{nullptr};
     ALbuffer *Buffer{nullptr};
+    ALuint DeviceBus{0};
 
     struct EffectData {
         EffectSlotType Type{EffectSlotType::None};
@@ -359,6 +360,10 @@ public:
 };
 
 void UpdateAllEffectSlotProps(ALCcontext *context);
+/* Takes the context's effect slots off their device buses, giving up any the
+ * slots own. The caller must wait for the mix before the slots are freed.
+ */
+void LeaveAllDeviceBuses(ALCcontext *context);
 
 #ifdef ALSOFT_EAX
 using EaxAlEffectSlotUPtr = std::unique_ptr<ALeffectslot, ALeffectslot::EaxDeleter>;
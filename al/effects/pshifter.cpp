@@ -1,10 +1,15 @@
 
 #include "config.h"
 
+#include <optional>
+#include <stdexcept>
+#include <string>
+
 #include "AL/al.h"
 #include "AL/efx.h"
 
 #include "alc/effects/base.h"
+#include "alc/inprogext.h"
 #include "effects.h"
 
 #ifdef ALSOFT_EAX
@@ -17,11 +22,34 @@
 
 namespace {
 
+constexpr std::optional<PshifterQuality> QualityFromEnum(ALenum value) noexcept
+{
+    switch(value)
+    {
+    case AL_PITCH_SHIFTER_QUALITY_HIGH_SOFT: return PshifterQuality::High;
+    case AL_PITCH_SHIFTER_QUALITY_MEDIUM_SOFT: return PshifterQuality::Medium;
+    case AL_PITCH_SHIFTER_QUALITY_LOW_SOFT: return PshifterQuality::Low;
+    }
+    return std::nullopt;
+}
+constexpr ALenum EnumFromQuality(PshifterQuality quality)
+{
+    switch(quality)
+    {
+    case PshifterQuality::High: return AL_PITCH_SHIFTER_QUALITY_HIGH_SOFT;
+    case PshifterQuality::Medium: return AL_PITCH_SHIFTER_QUALITY_MEDIUM_SOFT;
+    case PshifterQuality::Low: return AL_PITCH_SHIFTER_QUALITY_LOW_SOFT;
+    }
+    throw std::runtime_error{"Invalid pitch shifter quality: " +
+        std::to_string(static_cast<int>(quality))};
+}
+
 constexpr EffectProps genDefaultProps() noexcept
 {
     PshifterProps props{};
     props.CoarseTune = AL_PITCH_SHIFTER_DEFAULT_COARSE_TUNE;
     props.FineTune = AL_PITCH_SHIFTER_DEFAULT_FINE_TUNE;
+    props.Quality = QualityFromEnum(AL_PITCH_SHIFTER_DEFAULT_QUALITY_SOFT).value();
     return props;
 }
 
@@ -45,6 +73,14 @@ void PshifterEffectHandler::SetParami(PshifterProps &props, ALenum param, int va
         props.FineTune = val;
         break;
 
+    case AL_PITCH_SHIFTER_QUALITY_SOFT:
+        if(auto qualopt = QualityFromEnum(val))
+            props.Quality = *qualopt;
+        else
+            throw effect_exception{AL_INVALID_VALUE, "Invalid pitch shifter quality: 0x%04x",
+                val};
+        break;
+
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid pitch shifter integer property 0x%04x",
             param};
@@ -67,6 +103,7 @@ void PshifterEffectHandler::GetParami(const PshifterProps &props, ALenum param,
     {
     case AL_PITCH_SHIFTER_COARSE_TUNE: *val = props.CoarseTune; break;
     case AL_PITCH_SHIFTER_FINE_TUNE: *val = props.FineTune; break;
+    case AL_PITCH_SHIFTER_QUALITY_SOFT: *val = EnumFromQuality(props.Quality); break;
 
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid pitch shifter integer property 0x%04x",
@@ -3,10 +3,12 @@
 
 #include "event.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bitset>
 #include <exception>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <new>
@@ -23,6 +25,7 @@
 #include "AL/alext.h"
 
 #include "alc/context.h"
+#include "alc/inprogext.h"
 #include "alsem.h"
 #include "alspan.h"
 #include "core/async_event.h"
@@ -39,26 +42,69 @@
 
 namespace {
 
+using namespace std::string_view_literals;
+
 template<typename... Ts>
 struct overloaded : Ts... { using Ts::operator()...; };
 
 template<typename... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+constexpr auto GetSourceStateEnum(AsyncSrcState state) noexcept -> ALuint
+{
+    switch(state)
+    {
+    case AsyncSrcState::Reset: return AL_INITIAL;
+    case AsyncSrcState::Stop: return AL_STOPPED;
+    case AsyncSrcState::Play: return AL_PLAYING;
+    case AsyncSrcState::Pause: return AL_PAUSED;
+    }
+    return AL_NONE;
+}
+
 int EventThread(ALCcontext *context)
 {
     RingBuffer *ring{context->mAsyncEvents.get()};
+
+    /* Events for the batch callback are collected here, and passed on when
+     * it fills or the ready events have been handled.
+     */
+    std::array<ALeventSOFT,64> batch{};
+    size_t batchcount{0};
+    auto flush_batch = [context,&batch,&batchcount]
+    {
+        if(batchcount > 0 && context->mEventBatchCb)
+            context->mEventBatchCb(batch.data(), static_cast<ALsizei>(batchcount),
+                context->mEventBatchParam);
+        batchcount = 0;
+    };
+    auto add_batch = [context,&batch,&batchcount,&flush_batch](ALenum type, ALuint object,
+        ALuint param)
+    {
+        if(!context->mEventBatchCb)
+            return;
+        batch[batchcount++] = ALeventSOFT{type, object, param};
+        if(batchcount == batch.size())
+            flush_batch();
+    };
+
     bool quitnow{false};
     while(!quitnow)
     {
-        auto evt_data = ring->getReadVector().first;
-        if(evt_data.len == 0)
+        /* Leave the events to the app while it's polling for them. */
+        if(ring->readSpace() == 0 || context->mEventPolling.load(std::memory_order_acquire))
         {
             context->mEventSem.wait();
             continue;
         }
 
         std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+        if(context->mEventPolling.load(std::memory_order_relaxed))
+            continue;
+        auto evt_data = ring->getReadVector().first;
+        if(evt_data.len == 0)
+            continue;
+
         auto evt_span = al::span{std::launder(reinterpret_cast<AsyncEvent*>(evt_data.buf)),
             evt_data.len};
         for(auto &event : evt_span)
@@ -72,41 +118,49 @@ int EventThread(ALCcontext *context)
             {
                 al::intrusive_ptr<EffectState>{evt.mEffectState};
             };
-            auto proc_srcstate = [context,enabledevts](AsyncSourceStateEvent &evt)
+            auto proc_srcstate = [context,enabledevts,&add_batch](AsyncSourceStateEvent &evt)
             {
-                if(!context->mEventCb
-                    || !enabledevts.test(al::to_underlying(AsyncEnableBits::SourceState)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::SourceState)))
                     return;
 
                 ALuint state{};
-                std::string msg{"Source ID " + std::to_string(evt.mId)};
-                msg += " state has changed to ";
+                std::string_view statename;
                 switch(evt.mState)
                 {
                 case AsyncSrcState::Reset:
-                    msg += "AL_INITIAL";
+                    statename = "AL_INITIAL"sv;
                     state = AL_INITIAL;
                     break;
                 case AsyncSrcState::Stop:
-                    msg += "AL_STOPPED";
+                    statename = "AL_STOPPED"sv;
                     state = AL_STOPPED;
                     break;
                 case AsyncSrcState::Play:
-                    msg += "AL_PLAYING";
+                    statename = "AL_PLAYING"sv;
                     state = AL_PLAYING;
                     break;
                 case AsyncSrcState::Pause:
-                    msg += "AL_PAUSED";
+                    statename = "AL_PAUSED"sv;
                     state = AL_PAUSED;
                     break;
                 }
+                add_batch(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.mId, state);
+                if(!context->mEventCb)
+                    return;
+
+                std::string msg{"Source ID " + std::to_string(evt.mId)};
+                msg += " state has changed to ";
+                msg += statename;
                 context->mEventCb(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.mId, state,
                     static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
             };
-            auto proc_buffercomp = [context,enabledevts](AsyncBufferCompleteEvent &evt)
+            auto proc_buffercomp = [context,enabledevts,&add_batch](AsyncBufferCompleteEvent &evt)
             {
-                if(!context->mEventCb
-                    || !enabledevts.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+                    return;
+
+                add_batch(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.mId, evt.mCount);
+                if(!context->mEventCb)
                     return;
 
                 std::string msg{std::to_string(evt.mCount)};
@@ -115,21 +169,47 @@ int EventThread(ALCcontext *context)
                 context->mEventCb(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.mId, evt.mCount,
                     static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
             };
-            auto proc_disconnect = [context,enabledevts](AsyncDisconnectEvent &evt)
+            auto proc_disconnect = [context,enabledevts,&add_batch](AsyncDisconnectEvent &evt)
             {
                 context->debugMessage(DebugSource::System, DebugType::Error, 0,
                     DebugSeverity::High, evt.msg);
 
-                if(context->mEventCb
-                    && enabledevts.test(al::to_underlying(AsyncEnableBits::Disconnected)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::Disconnected)))
+                    return;
+
+                add_batch(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0);
+                if(context->mEventCb)
                     context->mEventCb(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0,
                         static_cast<ALsizei>(evt.msg.length()), evt.msg.c_str(),
                         context->mEventParam);
             };
+            auto proc_mixerload = [context,enabledevts,&add_batch](AsyncMixerLoadEvent &evt)
+            {
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::MixerLoad)))
+                    return;
+
+                add_batch(AL_EVENT_TYPE_MIXER_LOAD_SOFT, evt.mPeakLoad,
+                    evt.mDeadlineMisses + evt.mUnderruns);
+                if(!context->mEventCb)
+                    return;
+
+                std::string msg{"Mixer load peaked at " + std::to_string(evt.mPeakLoad) + "%"};
+                msg += ", " + std::to_string(evt.mDeadlineMisses) + " deadline miss";
+                if(evt.mDeadlineMisses != 1) msg += "es";
+                msg += ", " + std::to_string(evt.mUnderruns) + " underrun";
+                if(evt.mUnderruns != 1) msg += "s";
+                context->mEventCb(AL_EVENT_TYPE_MIXER_LOAD_SOFT, evt.mPeakLoad,
+                    evt.mDeadlineMisses + evt.mUnderruns, static_cast<ALsizei>(msg.length()),
+                    msg.c_str(), context->mEventParam);
+            };
 
             std::visit(overloaded{proc_srcstate, proc_buffercomp, proc_release, proc_disconnect,
-                proc_killthread}, event);
+                proc_mixerload, proc_killthread}, event);
         }
+        /* Pass on the batch while still holding the lock, so changing the
+         * callbacks or enabled events never has any left over.
+         */
+        flush_batch();
         std::destroy(evt_span.begin(), evt_span.end());
         ring->readAdvance(evt_span.size());
     }
@@ -143,6 +223,7 @@ constexpr std::optional<AsyncEnableBits> GetEventType(ALenum etype) noexcept
     case AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT: return AsyncEnableBits::BufferCompleted;
     case AL_EVENT_TYPE_DISCONNECTED_SOFT: return AsyncEnableBits::Disconnected;
     case AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT: return AsyncEnableBits::SourceState;
+    case AL_EVENT_TYPE_MIXER_LOAD_SOFT: return AsyncEnableBits::MixerLoad;
     }
     return std::nullopt;
 }
@@ -165,6 +246,9 @@ void StartEventThrd(ALCcontext *ctx)
 
 void StopEventThrd(ALCcontext *ctx)
 {
+    /* The event thread needs to see the kill event. */
+    SetEventPolling(ctx, false);
+
     RingBuffer *ring{ctx->mAsyncEvents.get()};
     auto evt_data = ring->getWriteVector().first;
     if(evt_data.len == 0)
@@ -182,6 +266,24 @@ void StopEventThrd(ALCcontext *ctx)
         ctx->mEventThread.join();
 }
 
+void SetEventPolling(ALCcontext *ctx, bool enable)
+{
+    std::lock_guard<std::mutex> eventlock{ctx->mEventCbLock};
+    if(enable)
+    {
+        ctx->initEventFd();
+        ctx->mEventPolling.store(true, std::memory_order_release);
+        /* Signal any events that were already waiting. */
+        if(ctx->mAsyncEvents->readSpace() > 0)
+            ctx->signalEvents();
+    }
+    else if(ctx->mEventPolling.exchange(false, std::memory_order_acq_rel))
+    {
+        /* Have the event thread handle any that were left. */
+        ctx->mEventSem.post();
+    }
+}
+
 AL_API DECL_FUNCEXT3(void, alEventControl,SOFT, ALsizei,count, const ALenum*,types, ALboolean,enable)
 FORCE_ALIGN void AL_APIENTRY alEventControlDirectSOFT(ALCcontext *context, ALsizei count,
     const ALenum *types, ALboolean enable) noexcept
@@ -238,3 +340,94 @@ FORCE_ALIGN void AL_APIENTRY alEventCallbackDirectSOFT(ALCcontext *context,
     context->mEventCb = callback;
     context->mEventParam = userParam;
 }
+
+AL_API DECL_FUNCEXT2(void, alEventBatchCallback,SOFT, ALEVENTBATCHPROCSOFT,callback, void*,userParam)
+FORCE_ALIGN void AL_APIENTRY alEventBatchCallbackDirectSOFT(ALCcontext *context,
+    ALEVENTBATCHPROCSOFT callback, void *userParam) noexcept
+{
+    std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    context->mEventBatchCb = callback;
+    context->mEventBatchParam = userParam;
+}
+
+AL_API DECL_FUNCEXT2(ALsizei, alPollEvents,SOFT, ALeventSOFT*,events, ALsizei,count)
+FORCE_ALIGN ALsizei AL_APIENTRY alPollEventsDirectSOFT(ALCcontext *context, ALeventSOFT *events,
+    ALsizei count) noexcept
+try {
+    if(count < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Polling %d events", count};
+    if(count > 0 && !events)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    if(!context->mEventPolling.load(std::memory_order_relaxed))
+        throw al::context_error{AL_INVALID_OPERATION, "Event polling not enabled"};
+
+    /* Clear the signal before reading, so events written after this get
+     * signaled again.
+     */
+    context->clearEventFd();
+
+    const auto enabledevts = context->mEnabledEvts.load(std::memory_order_acquire);
+    const auto output = al::span{events, static_cast<uint>(count)};
+    auto outiter = output.begin();
+    auto proc_killthread = [](AsyncKillThread&) { };
+    auto proc_release = [](AsyncEffectReleaseEvent &evt)
+    {
+        al::intrusive_ptr<EffectState>{evt.mEffectState};
+    };
+    auto proc_srcstate = [enabledevts,&outiter](AsyncSourceStateEvent &evt)
+    {
+        if(enabledevts.test(al::to_underlying(AsyncEnableBits::SourceState)))
+            *(outiter++) = ALeventSOFT{AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.mId,
+                GetSourceStateEnum(evt.mState)};
+    };
+    auto proc_buffercomp = [enabledevts,&outiter](AsyncBufferCompleteEvent &evt)
+    {
+        if(enabledevts.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+            *(outiter++) = ALeventSOFT{AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.mId, evt.mCount};
+    };
+    auto proc_disconnect = [context,enabledevts,&outiter](AsyncDisconnectEvent &evt)
+    {
+        context->debugMessage(DebugSource::System, DebugType::Error, 0, DebugSeverity::High,
+            evt.msg);
+        if(enabledevts.test(al::to_underlying(AsyncEnableBits::Disconnected)))
+            *(outiter++) = ALeventSOFT{AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0};
+    };
+    auto proc_mixerload = [enabledevts,&outiter](AsyncMixerLoadEvent &evt)
+    {
+        if(enabledevts.test(al::to_underlying(AsyncEnableBits::MixerLoad)))
+            *(outiter++) = ALeventSOFT{AL_EVENT_TYPE_MIXER_LOAD_SOFT, evt.mPeakLoad,
+                evt.mDeadlineMisses + evt.mUnderruns};
+    };
+
+    RingBuffer *ring{context->mAsyncEvents.get()};
+    while(outiter != output.end())
+    {
+        auto evt_data = ring->getReadVector().first;
+        if(evt_data.len == 0)
+            break;
+
+        /* Each event writes at most one output, so only take as many as
+         * there's room for.
+         */
+        const auto numevts = std::min(evt_data.len,
+            static_cast<size_t>(std::distance(outiter, output.end())));
+        auto evt_span = al::span{std::launder(reinterpret_cast<AsyncEvent*>(evt_data.buf)),
+            numevts};
+        for(auto &event : evt_span)
+            std::visit(overloaded{proc_srcstate, proc_buffercomp, proc_release,
+                proc_disconnect, proc_mixerload, proc_killthread}, event);
+        std::destroy(evt_span.begin(), evt_span.end());
+        ring->readAdvance(evt_span.size());
+    }
+
+    /* Keep the app signaled if there's more to read. */
+    if(ring->readSpace() > 0)
+        context->signalEvents();
+    return static_cast<ALsizei>(std::distance(output.begin(), outiter));
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+    return 0;
+}
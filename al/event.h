@@ -6,4 +6,9 @@ struct ALCcontext;
 void StartEventThrd(ALCcontext *ctx);
 void StopEventThrd(ALCcontext *ctx);
 
+/* Switches between the app polling for events and the event thread handling
+ * them.
+ */
+void SetEventPolling(ALCcontext *ctx, bool enable);
+
 #endif
@@ -111,17 +111,32 @@ Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
 void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context)
 {
     /* Get an unused property container, or allocate a new one as needed. */
-    VoicePropsItem *props{context->mFreeVoiceProps.load(std::memory_order_acquire)};
-    if(!props)
+    auto get_props = [context,voice]() -> VoicePropsItem*
     {
-        context->allocVoiceProps();
-        props = context->mFreeVoiceProps.load(std::memory_order_acquire);
-    }
-    VoicePropsItem *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(context->mFreeVoiceProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+        VoicePropsItem *props{context->mFreeVoiceProps.load(std::memory_order_acquire)};
+        if(!props) UNLIKELY
+        {
+            /* Fixed pools overwrite the voice's pending update, if it has
+             * one, rather than allocating more.
+             */
+            if(context->mFixedPools)
+            {
+                if(auto *pending = voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel))
+                    return pending;
+                context->mVoicePropsUsage.mExhausted.fetch_add(1u, std::memory_order_relaxed);
+            }
+            context->allocVoiceProps();
+            props = context->mFreeVoiceProps.load(std::memory_order_acquire);
+        }
+        VoicePropsItem *next;
+        do {
+            next = props->next.load(std::memory_order_relaxed);
+        } while(context->mFreeVoiceProps.compare_exchange_weak(props, next,
+            std::memory_order_acq_rel, std::memory_order_acquire) == false);
+        context->mVoicePropsUsage.take();
+        return props;
+    };
+    VoicePropsItem *props{get_props()};
 
     props->Pitch = source->Pitch;
     props->Gain = source->Gain;
@@ -192,6 +207,7 @@ void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context
          * freelist.
          */
         AtomicReplaceHead(context->mFreeVoiceProps, props);
+        context->mVoicePropsUsage.give();
     }
 }
 
@@ -568,15 +584,40 @@ VoiceChange *GetVoiceChanger(ALCcontext *ctx)
     VoiceChange *vchg{ctx->mVoiceChangeTail};
     if(vchg == ctx->mCurrentVoiceChange.load(std::memory_order_acquire)) UNLIKELY
     {
+        if(ctx->mFixedPools)
+            ctx->mVoiceChangeUsage.mExhausted.fetch_add(1u, std::memory_order_relaxed);
         ctx->allocVoiceChanges();
         vchg = ctx->mVoiceChangeTail;
     }
 
     ctx->mVoiceChangeTail = vchg->mNext.exchange(nullptr, std::memory_order_relaxed);
+    ctx->mVoiceChangeUsage.take();
 
     return vchg;
 }
 
+/* Makes sure there are enough free voice changes for the given count,
+ * allocating more as needed. Fixed pools throw instead, before anything has
+ * changed.
+ */
+void ReserveVoiceChanges(ALCcontext *ctx, const size_t count)
+{
+    /* The mixer always holds on to its current voice change. */
+    const size_t inuse{ctx->mVoiceChangeUsage.inUse() + 1u};
+    if(ctx->numVoiceChanges() - inuse >= count) LIKELY
+        return;
+
+    if(ctx->mFixedPools)
+    {
+        ctx->mVoiceChangeUsage.mExhausted.fetch_add(1u, std::memory_order_relaxed);
+        throw al::context_error{AL_OUT_OF_MEMORY, "Out of voice changes (%zu in use, %zu needed)",
+            inuse-1u, count};
+    }
+    do {
+        ctx->allocVoiceChanges();
+    } while(ctx->numVoiceChanges() - inuse < count);
+}
+
 void SendVoiceChanges(ALCcontext *ctx, VoiceChange *tail)
 {
     ALCdevice *device{ctx->mALDevice.get()};
@@ -596,13 +637,19 @@ void SendVoiceChanges(ALCcontext *ctx, VoiceChange *tail)
              * ignore all pending changes.
              */
             VoiceChange *cur{ctx->mCurrentVoiceChange.load(std::memory_order_acquire)};
+            size_t count{0};
             while(VoiceChange *next{cur->mNext.load(std::memory_order_acquire)})
             {
                 cur = next;
+                ++count;
                 if(Voice *voice{cur->mVoice})
+                {
                     voice->mSourceID.store(0, std::memory_order_relaxed);
+                    ctx->addFreeVoice(voice);
+                }
             }
             ctx->mCurrentVoiceChange.store(cur, std::memory_order_release);
+            ctx->mVoiceChangeUsage.give(count);
         }
     }
 }
@@ -612,42 +659,7 @@ bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALC
     ALCdevice *device)
 {
     /* First, get a free voice to start at the new offset. */
-    auto voicelist = context->getVoicesSpan();
-    Voice *newvoice{};
-    ALuint vidx{0};
-    for(Voice *voice : voicelist)
-    {
-        if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-            && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-            && voice->mPendingChange.load(std::memory_order_relaxed) == false)
-        {
-            newvoice = voice;
-            break;
-        }
-        ++vidx;
-    }
-    if(!newvoice) UNLIKELY
-    {
-        auto &allvoices = *context->mVoices.load(std::memory_order_relaxed);
-        if(allvoices.size() == voicelist.size())
-            context->allocVoices(1);
-        context->mActiveVoiceCount.fetch_add(1, std::memory_order_release);
-        voicelist = context->getVoicesSpan();
-
-        vidx = 0;
-        for(Voice *voice : voicelist)
-        {
-            if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-                && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-                && voice->mPendingChange.load(std::memory_order_relaxed) == false)
-            {
-                newvoice = voice;
-                break;
-            }
-            ++vidx;
-        }
-        ASSUME(newvoice != nullptr);
-    }
+    Voice *newvoice{context->getFreeVoice()};
 
     /* Initialize the new voice and set its starting offset.
      * TODO: It might be better to have the VoiceChange processing copy the old
@@ -661,12 +673,14 @@ bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALC
     newvoice->mPositionFrac.store(vpos.frac, std::memory_order_relaxed);
     newvoice->mCurrentBuffer.store(vpos.bufferitem, std::memory_order_relaxed);
     newvoice->mStartTime = oldvoice->mStartTime;
+    /* The mixer carries over any scheduled stop, pause, or gain ramp. */
+    newvoice->mStopTime = nanoseconds::max();
     newvoice->mFlags.reset();
     if(vpos.pos > 0 || (vpos.pos == 0 && vpos.frac > 0)
         || vpos.bufferitem != &source->mQueue.front())
         newvoice->mFlags.set(VoiceIsFading);
     InitVoice(newvoice, source, vpos.bufferitem, context, device);
-    source->VoiceIdx = vidx;
+    source->VoiceIdx = newvoice->mVoiceIdx;
 
     /* Set the old voice as having a pending change, and send it off with the
      * new one with a new offset voice change.
@@ -704,6 +718,7 @@ bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALC
     newvoice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
     newvoice->mSourceID.store(0u, std::memory_order_relaxed);
     newvoice->mPlayState.store(Voice::Stopped, std::memory_order_relaxed);
+    context->addFreeVoice(newvoice);
     return false;
 }
 
@@ -721,8 +736,15 @@ inline bool IsPlayingOrPaused(ALsource *source)
  */
 inline ALenum GetSourceState(ALsource *source, Voice *voice)
 {
-    if(!voice && source->state == AL_PLAYING)
-        source->state = AL_STOPPED;
+    if(source->state == AL_PLAYING)
+    {
+        if(!voice)
+            source->state = AL_STOPPED;
+        /* The mixer may have paused the voice at a scheduled time. */
+        else if(voice->mMixerPaused.load(std::memory_order_relaxed)
+            && voice->mMixerPaused.exchange(false, std::memory_order_acquire))
+            source->state = AL_PAUSED;
+    }
     return source->state;
 }
 
@@ -1672,6 +1694,7 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
             auto vpos = GetSampleOffset(Source->mQueue, prop, static_cast<double>(values[0]));
             if(!vpos) throw al::context_error{AL_INVALID_VALUE, "Invalid offset"};
 
+            ReserveVoiceChanges(Context, 1);
             if(SetVoiceOffset(voice, *vpos, Source, Context, Context->mALDevice.get()))
                 return;
         }
@@ -2514,32 +2537,14 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
         }
     }
 
-    /* Count the number of reusable voices. */
-    auto voicelist = context->getVoicesSpan();
-    size_t free_voices{0};
-    for(const Voice *voice : voicelist)
-    {
-        free_voices += (voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-            && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-            && voice->mPendingChange.load(std::memory_order_relaxed) == false);
-        if(free_voices == srchandles.size())
-            break;
-    }
-    if(srchandles.size() != free_voices) UNLIKELY
-    {
-        const size_t inc_amount{srchandles.size() - free_voices};
-        auto &allvoices = *context->mVoices.load(std::memory_order_relaxed);
-        if(inc_amount > allvoices.size() - voicelist.size())
-        {
-            /* Increase the number of voices to handle the request. */
-            context->allocVoices(inc_amount - (allvoices.size() - voicelist.size()));
-        }
-        context->mActiveVoiceCount.fetch_add(inc_amount, std::memory_order_release);
-        voicelist = context->getVoicesSpan();
-    }
+    /* Make sure there are enough free voices and voice changes to handle the
+     * request.
+     */
+    ReserveVoiceChanges(context, srchandles.size());
+    const size_t free_voices{context->mFreeVoiceCount.load(std::memory_order_relaxed)};
+    if(srchandles.size() > free_voices) UNLIKELY
+        context->allocVoices(srchandles.size() - free_voices);
 
-    auto voiceiter = voicelist.begin();
-    ALuint vidx{0};
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
     {
@@ -2611,24 +2616,18 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
             break;
         }
 
-        /* Find the next unused voice to play this source with. */
-        for(;voiceiter != voicelist.end();++voiceiter,++vidx)
-        {
-            Voice *v{*voiceiter};
-            if(v->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-                && v->mSourceID.load(std::memory_order_relaxed) == 0u
-                && v->mPendingChange.load(std::memory_order_relaxed) == false)
-            {
-                voice = v;
-                break;
-            }
-        }
-        ASSUME(voice != nullptr);
+        /* Get an unused voice to play this source with. */
+        voice = context->getFreeVoice();
 
         voice->mPosition.store(0, std::memory_order_relaxed);
         voice->mPositionFrac.store(0, std::memory_order_relaxed);
         voice->mCurrentBuffer.store(&source->mQueue.front(), std::memory_order_relaxed);
         voice->mStartTime = start_time;
+        voice->mStopTime = nanoseconds::max();
+        voice->mStopPauses = false;
+        voice->mMixerPaused.store(false, std::memory_order_relaxed);
+        voice->mRampGain = 1.0f;
+        voice->mRampTarget = 1.0f;
         voice->mFlags.reset();
         /* A source that's not playing or paused has any offset applied when it
          * starts playing.
@@ -2650,7 +2649,7 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
         }
         InitVoice(voice, source, al::to_address(BufferList), context, device);
 
-        source->VoiceIdx = vidx;
+        source->VoiceIdx = voice->mVoiceIdx;
         source->state = AL_PLAYING;
 
         cur->mVoice = voice;
@@ -2661,6 +2660,43 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
         SendVoiceChanges(context, tail);
 }
 
+/* Schedules a change for the given sources, all with one batch of voice
+ * changes. Sources that aren't playing (or paused, for gain ramps) are
+ * ignored.
+ */
+void ScheduleSources(ALCcontext *const context, const al::span<ALsource*> srchandles,
+    const VChangeState state, const nanoseconds time, const nanoseconds endtime = {},
+    const float gain = 0.0f)
+{
+    ReserveVoiceChanges(context, srchandles.size());
+
+    VoiceChange *tail{}, *cur{};
+    for(ALsource *source : srchandles)
+    {
+        Voice *voice{GetSourceVoice(source, context)};
+        const ALenum srcstate{GetSourceState(source, voice)};
+        if(srcstate != AL_PLAYING && !(srcstate == AL_PAUSED && state == VChangeState::GainRamp))
+            continue;
+
+        if(!cur)
+            cur = tail = GetVoiceChanger(context);
+        else
+        {
+            cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
+            cur = cur->mNext.load(std::memory_order_relaxed);
+        }
+        voice->mPendingChange.store(true, std::memory_order_relaxed);
+        cur->mVoice = voice;
+        cur->mSourceID = source->id;
+        cur->mState = state;
+        cur->mTime = time;
+        cur->mEndTime = endtime;
+        cur->mGain = gain;
+    }
+    if(tail) LIKELY
+        SendVoiceChanges(context, tail);
+}
+
 } // namespace
 
 AL_API DECL_FUNC2(void, alGenSources, ALsizei,n, ALuint*,sources)
@@ -3166,6 +3202,108 @@ catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
 }
 
+AL_API DECL_FUNCEXT5(void, alGetSourceStates,SOFT, ALsizei,n, const ALuint*,sources, ALenum*,states, ALint64SOFT*,offsets, ALint64SOFT*,clocklatency)
+FORCE_ALIGN void AL_APIENTRY alGetSourceStatesDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALenum *states, ALint64SOFT *offsets,
+    ALint64SOFT *clocklatency) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Querying %d sources", n};
+    if(n > 0 && !sources)
+        throw al::context_error{AL_INVALID_VALUE, "NULL sources pointer"};
+
+    struct SourcePos {
+        ALsource *source;
+        Voice *voice;
+        const VoiceBufferItem *current;
+        int64_t readpos;
+    };
+    using SourcePosArray = std::array<SourcePos,16>;
+    using SourcePosVector = std::vector<SourcePos>;
+    std::variant<std::monostate,SourcePosArray,SourcePosVector> pos_store;
+    const auto srcpos = [&pos_store](size_t count) -> al::span<SourcePos>
+    {
+        if(count > std::tuple_size_v<SourcePosArray>)
+            return al::span{pos_store.emplace<SourcePosVector>(count)};
+        return al::span{pos_store.emplace<SourcePosArray>()}.first(count);
+    }(static_cast<ALuint>(n));
+
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> SourcePos
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return SourcePos{src, nullptr, nullptr, 0};
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sources, sources+srcpos.size(), srcpos.begin(), lookup_src);
+
+    /* Read all the voices in one pass between mixes, so the offsets are all
+     * for the same clock time.
+     */
+    ALCdevice *device{context->mALDevice.get()};
+    nanoseconds srcclock{};
+    uint refcount{};
+    do {
+        refcount = device->waitForMix();
+        srcclock = device->getClockTime();
+        for(SourcePos &pos : srcpos)
+        {
+            pos.voice = GetSourceVoice(pos.source, context);
+            if(Voice *voice{pos.voice})
+            {
+                pos.current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
+                pos.readpos = int64_t{voice->mPosition.load(std::memory_order_relaxed)}
+                    << MixerFracBits;
+                pos.readpos += voice->mPositionFrac.load(std::memory_order_relaxed);
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
+
+    for(size_t i{0};i < srcpos.size();++i)
+    {
+        SourcePos &pos = srcpos[i];
+        if(states)
+            states[i] = GetSourceState(pos.source, pos.voice);
+        if(!offsets)
+            continue;
+
+        if(!pos.voice)
+        {
+            offsets[i] = 0;
+            continue;
+        }
+        int64_t readpos{pos.readpos};
+        for(auto &item : pos.source->mQueue)
+        {
+            if(&item == pos.current) break;
+            readpos += int64_t{item.mSampleLen} << MixerFracBits;
+        }
+        if(readpos > std::numeric_limits<int64_t>::max() >> (32-MixerFracBits))
+            offsets[i] = std::numeric_limits<int64_t>::max();
+        else
+            offsets[i] = readpos << (32-MixerFracBits);
+    }
+
+    if(clocklatency)
+    {
+        /* As with AL_SAMPLE_OFFSET_LATENCY_SOFT, reduce the latency by how
+         * much the clock advanced since the offsets were read.
+         */
+        ClockLatency clocktime{};
+        {
+            std::lock_guard<std::mutex> statelock{device->StateLock};
+            clocktime = GetClockLatency(device, device->Backend.get());
+        }
+        const auto diff = std::min(clocktime.Latency, clocktime.ClockTime-srcclock);
+        clocklatency[0] = srcclock.count();
+        clocklatency[1] = nanoseconds{clocktime.Latency - diff}.count();
+    }
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
 
 AL_API DECL_FUNC1(void, alSourcePlay, ALuint,source)
 FORCE_ALIGN void AL_APIENTRY alSourcePlayDirect(ALCcontext *context, ALuint source) noexcept
@@ -3296,6 +3434,7 @@ try {
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
     };
     std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+    ReserveVoiceChanges(context, srchandles.size());
 
     /* Pausing has to be done in two steps. First, for each source that's
      * detected to be playing, chamge the voice (asynchronously) to
@@ -3369,6 +3508,7 @@ try {
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
     };
     std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+    ReserveVoiceChanges(context, srchandles.size());
 
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
@@ -3399,6 +3539,134 @@ catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
 }
 
+FORCE_ALIGN DECL_FUNCEXT2(void, alSourceStopAtTime,SOFT, ALuint,source, ALint64SOFT,stop_time)
+FORCE_ALIGN void AL_APIENTRY alSourceStopAtTimeDirectSOFT(ALCcontext *context, ALuint source,
+    ALint64SOFT stop_time) noexcept
+{ alSourceStopAtTimevDirectSOFT(context, 1, &source, stop_time); }
+
+FORCE_ALIGN DECL_FUNCEXT3(void, alSourceStopAtTimev,SOFT, ALsizei,n, const ALuint*,sources, ALint64SOFT,stop_time)
+FORCE_ALIGN void AL_APIENTRY alSourceStopAtTimevDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALint64SOFT stop_time) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Stopping %d sources", n};
+    if(n <= 0) UNLIKELY return;
+
+    if(stop_time < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid time point %" PRId64, stop_time};
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t count) -> al::span<ALsource*>
+    {
+        if(count > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(count)};
+        return al::span{source_store.emplace<source_store_array>()}.first(count);
+    }(sids.size());
+
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> ALsource*
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return src;
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+    /* The sources stay playing until the mixer gets to the stop time. */
+    ScheduleSources(context, srchandles, VChangeState::StopAt, nanoseconds{stop_time});
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+FORCE_ALIGN DECL_FUNCEXT2(void, alSourcePauseAtTime,SOFT, ALuint,source, ALint64SOFT,pause_time)
+FORCE_ALIGN void AL_APIENTRY alSourcePauseAtTimeDirectSOFT(ALCcontext *context, ALuint source,
+    ALint64SOFT pause_time) noexcept
+{ alSourcePauseAtTimevDirectSOFT(context, 1, &source, pause_time); }
+
+FORCE_ALIGN DECL_FUNCEXT3(void, alSourcePauseAtTimev,SOFT, ALsizei,n, const ALuint*,sources, ALint64SOFT,pause_time)
+FORCE_ALIGN void AL_APIENTRY alSourcePauseAtTimevDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALint64SOFT pause_time) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Pausing %d sources", n};
+    if(n <= 0) UNLIKELY return;
+
+    if(pause_time < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid time point %" PRId64, pause_time};
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t count) -> al::span<ALsource*>
+    {
+        if(count > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(count)};
+        return al::span{source_store.emplace<source_store_array>()}.first(count);
+    }(sids.size());
+
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> ALsource*
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return src;
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+    /* The sources stay playing until the mixer gets to the pause time, which
+     * the sources pick up the next time their state is checked.
+     */
+    ScheduleSources(context, srchandles, VChangeState::PauseAt, nanoseconds{pause_time});
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+FORCE_ALIGN DECL_FUNCEXT4(void, alSourceRampGainAtTime,SOFT, ALuint,source, ALfloat,gain, ALint64SOFT,start_time, ALint64SOFT,end_time)
+FORCE_ALIGN void AL_APIENTRY alSourceRampGainAtTimeDirectSOFT(ALCcontext *context, ALuint source,
+    ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) noexcept
+{ alSourceRampGainAtTimevDirectSOFT(context, 1, &source, gain, start_time, end_time); }
+
+FORCE_ALIGN DECL_FUNCEXT5(void, alSourceRampGainAtTimev,SOFT, ALsizei,n, const ALuint*,sources, ALfloat,gain, ALint64SOFT,start_time, ALint64SOFT,end_time)
+FORCE_ALIGN void AL_APIENTRY alSourceRampGainAtTimevDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Ramping %d sources", n};
+    if(n <= 0) UNLIKELY return;
+
+    if(!(gain >= 0.0f && std::isfinite(gain)))
+        throw al::context_error{AL_INVALID_VALUE, "Invalid ramp gain %f", gain};
+    if(start_time < 0 || end_time < start_time)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid time range %" PRId64 " to %" PRId64,
+            start_time, end_time};
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t count) -> al::span<ALsource*>
+    {
+        if(count > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(count)};
+        return al::span{source_store.emplace<source_store_array>()}.first(count);
+    }(sids.size());
+
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> ALsource*
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return src;
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+    ScheduleSources(context, srchandles, VChangeState::GainRamp, nanoseconds{start_time},
+        nanoseconds{end_time}, gain);
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
 
 AL_API DECL_FUNC1(void, alSourceRewind, ALuint,source)
 FORCE_ALIGN void AL_APIENTRY alSourceRewindDirect(ALCcontext *context, ALuint source) noexcept
@@ -3429,6 +3697,7 @@ try {
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
     };
     std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+    ReserveVoiceChanges(context, srchandles.size());
 
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
@@ -37,6 +37,7 @@
 #include "AL/alext.h"
 
 #include "al/debug.h"
+#include "al/event.h"
 #include "al/listener.h"
 #include "alc/alu.h"
 #include "alc/context.h"
@@ -159,6 +160,7 @@ enum PropertyValue : ALenum {
     MaxDebugGroupDepth = AL_MAX_DEBUG_GROUP_STACK_DEPTH_EXT,
     MaxLabelLength = AL_MAX_LABEL_LENGTH_EXT,
     ContextFlags = AL_CONTEXT_FLAGS_EXT,
+    EventPollFd = AL_EVENT_POLL_FD_SOFT,
 #ifdef ALSOFT_EAX
     EaxRamSize = AL_EAX_RAM_SIZE,
     EaxRamFree = AL_EAX_RAM_FREE,
@@ -259,6 +261,13 @@ void GetValue(ALCcontext *context, ALenum pname, T *values)
         *values = cast_value(context->mContextFlags.to_ulong());
         return;
 
+    case AL_EVENT_POLL_FD_SOFT:
+    {
+        std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+        *values = cast_value(context->mEventFd);
+        return;
+    }
+
 #ifdef ALSOFT_EAX
 #define EAX_ERROR "[alGetInteger] EAX not enabled"
 
@@ -330,6 +339,10 @@ FORCE_ALIGN void AL_APIENTRY alEnableDirect(ALCcontext *context, ALenum capabili
     case AL_STOP_SOURCES_ON_DISCONNECT_SOFT:
         context->setError(AL_INVALID_OPERATION, "Re-enabling AL_STOP_SOURCES_ON_DISCONNECT_SOFT not yet supported");
         return;
+
+    case AL_EVENT_POLLING_SOFT:
+        SetEventPolling(context, true);
+        return;
     }
     context->setError(AL_INVALID_VALUE, "Invalid enable property 0x%04x", capability);
 }
@@ -354,6 +367,10 @@ FORCE_ALIGN void AL_APIENTRY alDisableDirect(ALCcontext *context, ALenum capabil
     case AL_STOP_SOURCES_ON_DISCONNECT_SOFT:
         context->mStopVoicesOnDisconnect.store(false);
         return;
+
+    case AL_EVENT_POLLING_SOFT:
+        SetEventPolling(context, false);
+        return;
     }
     context->setError(AL_INVALID_VALUE, "Invalid disable property 0x%04x", capability);
 }
@@ -368,6 +385,8 @@ FORCE_ALIGN ALboolean AL_APIENTRY alIsEnabledDirect(ALCcontext *context, ALenum
     case AL_DEBUG_OUTPUT_EXT: return context->mDebugEnabled ? AL_TRUE : AL_FALSE;
     case AL_STOP_SOURCES_ON_DISCONNECT_SOFT:
         return context->mStopVoicesOnDisconnect.load() ? AL_TRUE : AL_FALSE;
+    case AL_EVENT_POLLING_SOFT:
+        return context->mEventPolling.load() ? AL_TRUE : AL_FALSE;
     }
     context->setError(AL_INVALID_VALUE, "Invalid is enabled property 0x%04x", capability);
     return AL_FALSE;
@@ -456,6 +475,14 @@ FORCE_ALIGN void AL_APIENTRY alGetPointervDirectSOFT(ALCcontext *context, ALenum
         *values = context->mEventParam;
         return;
 
+    case AL_EVENT_BATCH_CALLBACK_FUNCTION_SOFT:
+        *values = reinterpret_cast<void*>(context->mEventBatchCb);
+        return;
+
+    case AL_EVENT_BATCH_CALLBACK_USER_PARAM_SOFT:
+        *values = context->mEventBatchParam;
+        return;
+
     case AL_DEBUG_CALLBACK_FUNCTION_EXT:
         *values = reinterpret_cast<void*>(context->mDebugCb);
         return;
@@ -586,17 +613,33 @@ AL_API void AL_APIENTRY alDopplerVelocity(ALfloat value) noexcept
 void UpdateContextProps(ALCcontext *context)
 {
     /* Get an unused property container, or allocate a new one as needed. */
-    ContextProps *props{context->mFreeContextProps.load(std::memory_order_acquire)};
-    if(!props)
+    auto get_props = [context]() -> ContextProps*
     {
-        context->allocContextProps();
-        props = context->mFreeContextProps.load(std::memory_order_acquire);
-    }
-    ContextProps *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(context->mFreeContextProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+        ContextProps *props{context->mFreeContextProps.load(std::memory_order_acquire)};
+        if(!props) UNLIKELY
+        {
+            /* Fixed pools overwrite the pending update, if there is one,
+             * rather than allocating more.
+             */
+            if(context->mFixedPools)
+            {
+                if(auto *pending = context->mParams.ContextUpdate.exchange(nullptr,
+                    std::memory_order_acq_rel))
+                    return pending;
+                context->mContextPropsUsage.mExhausted.fetch_add(1u, std::memory_order_relaxed);
+            }
+            context->allocContextProps();
+            props = context->mFreeContextProps.load(std::memory_order_acquire);
+        }
+        ContextProps *next;
+        do {
+            next = props->next.load(std::memory_order_relaxed);
+        } while(context->mFreeContextProps.compare_exchange_weak(props, next,
+            std::memory_order_acq_rel, std::memory_order_acquire) == false);
+        context->mContextPropsUsage.take();
+        return props;
+    };
+    ContextProps *props{get_props()};
 
     /* Copy in current property values. */
     const auto &listener = context->mListener;
@@ -623,5 +666,6 @@ void UpdateContextProps(ALCcontext *context)
          * freelist.
          */
         AtomicReplaceHead(context->mFreeContextProps, props);
+        context->mContextPropsUsage.give();
     }
 }
@@ -44,6 +44,7 @@
 #include <cstring>
 #include <exception>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -86,6 +87,7 @@
 #include "core/cpu_caps.h"
 #include "core/devformat.h"
 #include "core/device.h"
+#include "core/effect_threads.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/filters/nfc.h"
@@ -315,6 +317,7 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_EXT_thread_local_context "
         "ALC_SOFT_loopback "
         "ALC_SOFT_loopback_bformat "
+        "ALC_SOFTX_loopback_planar "
         "ALC_SOFT_reopen_device "
         "ALC_SOFT_system_events"sv;
 }
@@ -333,6 +336,9 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_SOFT_HRTF "
         "ALC_SOFT_loopback "
         "ALC_SOFT_loopback_bformat "
+        "ALC_SOFTX_loopback_planar "
+        "ALC_SOFTX_mix_block_size "
+        "ALC_SOFTX_mixer_profile "
         "ALC_SOFT_output_limiter "
         "ALC_SOFT_output_mode "
         "ALC_SOFT_pause_device "
@@ -1046,6 +1052,8 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     std::optional<DevAmbiScaling> optscale;
     uint period_size{DefaultUpdateSize};
     uint buffer_size{DefaultUpdateSize * DefaultNumUpdates};
+    uint block_size{device->configValue<uint>({}, "block-size"sv).value_or(DefaultMixBlockSize)};
+    bool profiling{device->configValue<bool>({}, "mixer-profiling"sv).value_or(false)};
     int hrtf_id{-1};
     uint aorder{0u};
 
@@ -1266,6 +1274,18 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
                 outmode = attrList[attrIdx + 1];
                 break;
 
+            case ATTRIBUTE(ALC_MIX_BLOCK_SIZE_SOFT)
+                if(attrList[attrIdx + 1] > 0)
+                    block_size = static_cast<uint>(attrList[attrIdx + 1]);
+                break;
+
+            case ATTRIBUTE(ALC_MIXER_PROFILING_SOFT)
+                if(attrList[attrIdx + 1] == ALC_FALSE)
+                    profiling = false;
+                else if(attrList[attrIdx + 1] == ALC_TRUE)
+                    profiling = true;
+                break;
+
             default:
                 TRACE("0x%04X = %d (0x%x)\n", attrList[attrIdx],
                     attrList[attrIdx + 1], attrList[attrIdx + 1]);
@@ -1380,27 +1400,25 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     if(device->mDeviceState == DeviceState::Playing)
         return ALC_NO_ERROR;
 
-    device->mDeviceState = DeviceState::Unprepared;
-    device->AvgSpeakerDist = 0.0f;
-    device->mNFCtrlFilter = NfcFilter{};
-    device->mUhjEncoder = nullptr;
-    device->AmbiDecoder = nullptr;
-    device->Bs2b = nullptr;
-    device->PostProcess = nullptr;
-
-    device->Limiter = nullptr;
-    device->ChannelDelays = nullptr;
+    using ResetClock = std::chrono::steady_clock;
+    const auto reset_start = ResetClock::now();
+    auto stage_ms = [](ResetClock::time_point start, ResetClock::time_point end) -> double
+    { return std::chrono::duration<double,std::milli>(end - start).count(); };
 
-    std::fill(std::begin(device->HrtfAccumData), std::end(device->HrtfAccumData), float2{});
+    /* The renderer state is kept until the new output parameters are known,
+     * in case they're the same as before.
+     */
+    const ALCenum oldHrtfStatus{device->mHrtfStatus};
+    const uint oldAmbiOrder{device->mAmbiOrder};
+    const uint oldNumSends{device->NumAuxSends};
+    const uint oldBlockSize{device->mMixBlockSize};
+    const bool oldFshifterIIR{device->mFshifterIIR};
+    const size_t oldEffectThreads{device->mEffectThreads ? device->mEffectThreads->numThreads()
+        : 0u};
 
-    device->Dry.AmbiMap.fill(BFChannelConfig{});
-    device->Dry.Buffer = {};
-    std::fill(std::begin(device->NumChannelsPerOrder), std::end(device->NumChannelsPerOrder), 0u);
-    device->RealOut.RemixMap = {};
+    device->mDeviceState = DeviceState::Unprepared;
+    device->Limiter = nullptr;
     device->RealOut.ChannelIndex.fill(InvalidChannelIndex);
-    device->RealOut.Buffer = {};
-    device->MixBuffer.clear();
-    device->MixBuffer.shrink_to_fit();
 
     UpdateClockBase(device);
     device->FixedLatency = nanoseconds::zero();
@@ -1425,6 +1443,8 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             device->mAmbiLayout = *optlayout;
             device->mAmbiScale = *optscale;
         }
+        else
+            device->mAmbiOrder = 0;
         device->Flags.set(FrequencyRequest).set(ChannelsRequest).set(SampleTypeRequest);
     }
     else
@@ -1455,6 +1475,7 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
         }
     }
 
+    const auto backend_start = ResetClock::now();
     TRACE("Pre-reset: %s%s, %s%s, %s%uhz, %u / %u buffer\n",
         device->Flags.test(ChannelsRequest)?"*":"", DevFmtChannelsString(device->FmtChans),
         device->Flags.test(SampleTypeRequest)?"*":"", DevFmtTypeString(device->FmtType),
@@ -1496,6 +1517,44 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     TRACE("Post-reset: %s, %s, %uhz, %u / %u buffer\n",
         DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
         device->Frequency, device->UpdateSize, device->BufferSize);
+    const auto backend_end = ResetClock::now();
+
+    device->mMixBlockSize = std::clamp<uint>(block_size, MinMixBlockSize, MaxMixBlockSize);
+    TRACE("Mixing in blocks of up to %u samples\n", device->mMixBlockSize);
+
+    /* Profiling restarts with fresh statistics on each reset. */
+    device->mProfile = nullptr;
+    if(profiling)
+    {
+        device->mProfile = std::make_unique<MixerProfile>();
+        TRACE("Mixer profiling enabled\n");
+    }
+
+    device->mFshifterIIR = false;
+    if(auto filteropt = device->configValue<std::string>("frequency-shifter"sv, "filter"sv))
+    {
+        if(al::case_compare(*filteropt, "iir"sv) == 0)
+            device->mFshifterIIR = true;
+        else if(al::case_compare(*filteropt, "fir"sv) != 0)
+            WARN("Unsupported frequency-shifter/filter: %s\n", filteropt->c_str());
+    }
+
+    /* Keep the existing effect threads if the count didn't change. */
+    const uint effect_threads{std::min(
+        device->configValue<uint>({}, "effect-threads"sv).value_or(0u), 64u)};
+    if(!effect_threads)
+        device->mEffectThreads = nullptr;
+    else if(!device->mEffectThreads || device->mEffectThreads->numThreads() != effect_threads)
+    {
+        device->mEffectThreads = nullptr;
+        try {
+            device->mEffectThreads = std::make_unique<EffectThreadPool>(effect_threads);
+            TRACE("Processing effects with %u extra threads\n", effect_threads);
+        }
+        catch(std::exception &e) {
+            ERR("Failed to start effect threads: %s\n", e.what());
+        }
+    }
 
     if(device->Type != DeviceType::Loopback)
     {
@@ -1510,7 +1569,58 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
         }
     }
 
-    aluInitRenderer(device, hrtf_id, stereomode);
+    ALCdevice::RenderParams renderparams;
+    renderparams.Frequency = device->Frequency;
+    renderparams.FmtChans = device->FmtChans;
+    /* The renderer sets its own ambisonic order for other outputs. */
+    if(device->FmtChans == DevFmtAmbi3D)
+    {
+        renderparams.AmbiOrder = device->mAmbiOrder;
+        renderparams.AmbiLayout = device->mAmbiLayout;
+        renderparams.AmbiScale = device->mAmbiScale;
+    }
+    renderparams.ChannelIndex = device->RealOut.ChannelIndex;
+    renderparams.HrtfId = hrtf_id;
+    renderparams.StereoMode = stereomode;
+    renderparams.DirectEar = device->Flags.test(DirectEar);
+
+    const bool keeprenderer{device->mRenderParams && *device->mRenderParams == renderparams};
+    if(keeprenderer)
+    {
+        TRACE("Output unchanged, keeping the current renderer\n");
+        /* The format request clears these, but for other than ambisonic
+         * output, the renderer sets the order it mixes with.
+         */
+        device->mHrtfStatus = oldHrtfStatus;
+        device->mAmbiOrder = oldAmbiOrder;
+    }
+    else
+    {
+        device->mRenderParams.reset();
+
+        device->AvgSpeakerDist = 0.0f;
+        device->mNFCtrlFilter = NfcFilter{};
+        device->mUhjEncoder = nullptr;
+        device->AmbiDecoder = nullptr;
+        device->Bs2b = nullptr;
+        device->PostProcess = nullptr;
+        device->ChannelDelays = nullptr;
+
+        std::fill(std::begin(device->HrtfAccumData), std::end(device->HrtfAccumData), float2{});
+
+        device->Dry.AmbiMap.fill(BFChannelConfig{});
+        device->Dry.Buffer = {};
+        std::fill(std::begin(device->NumChannelsPerOrder), std::end(device->NumChannelsPerOrder),
+            0u);
+        device->RealOut.RemixMap = {};
+        device->RealOut.Buffer = {};
+        device->MixBuffer.clear();
+        device->MixBuffer.shrink_to_fit();
+
+        aluInitRenderer(device, hrtf_id, stereomode);
+        device->mRenderParams = renderparams;
+    }
+    const auto renderer_end = ResetClock::now();
 
     /* Calculate the max number of sources, and split them between the mono and
      * stereo count given the requested number of stereo sources.
@@ -1652,6 +1762,17 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     sample_delay = std::min<size_t>(sample_delay, std::numeric_limits<int>::max());
     device->FixedLatency += nanoseconds{seconds{sample_delay}} / device->Frequency;
     TRACE("Fixed device latency: %" PRId64 "ns\n", int64_t{device->FixedLatency.count()});
+    const auto output_end = ResetClock::now();
+
+    /* The contexts' effects and voices only need updating if the renderer or
+     * what they're set up for changed. That includes the effect threads, which
+     * the effect slots size their private output buffers for.
+     */
+    const size_t newEffectThreads{device->mEffectThreads ? device->mEffectThreads->numThreads()
+        : 0u};
+    const bool keepcontexts{keeprenderer && device->NumAuxSends == oldNumSends
+        && device->mMixBlockSize == oldBlockSize && device->mFshifterIIR == oldFshifterIIR
+        && newEffectThreads == oldEffectThreads};
 
     FPUCtl mixer_mode{};
     auto reset_context = [device](ContextBase *ctxbase)
@@ -1680,6 +1801,8 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             {
                 slot.mWetBuffer.clear();
                 slot.mWetBuffer.shrink_to_fit();
+                slot.mOutBuffer.clear();
+                slot.mOutBuffer.shrink_to_fit();
                 slot.Wet.Buffer = {};
             };
             std::for_each(clusterptr->begin(), clusterptr->end(), clear_buffer);
@@ -1730,6 +1853,7 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
         /* Clear all effect slot props to let them get allocated again. */
         context->mEffectSlotPropClusters.clear();
         context->mFreeEffectSlotProps.store(nullptr, std::memory_order_relaxed);
+        context->mEffectSlotPropsUsage.mInUse.store(0u, std::memory_order_relaxed);
         slotlock.unlock();
 
         std::unique_lock<std::mutex> srclock{context->mSourceLock};
@@ -1794,16 +1918,22 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
         /* Clear all voice props to let them get allocated again. */
         context->mVoicePropClusters.clear();
         context->mFreeVoiceProps.store(nullptr, std::memory_order_relaxed);
+        context->mVoicePropsUsage.mInUse.store(0u, std::memory_order_relaxed);
         srclock.unlock();
 
+        context->reserveProps();
         context->mPropsDirty = false;
         UpdateContextProps(context);
         UpdateAllEffectSlotProps(context);
         UpdateAllSourceProps(context);
     };
     auto ctxspan = al::span{*device->mContexts.load()};
-    std::for_each(ctxspan.begin(), ctxspan.end(), reset_context);
+    if(!keepcontexts)
+        std::for_each(ctxspan.begin(), ctxspan.end(), reset_context);
+    else if(!ctxspan.empty())
+        TRACE("Keeping the current context state\n");
     mixer_mode.leave();
+    const auto contexts_end = ResetClock::now();
 
     device->mDeviceState = DeviceState::Configured;
     if(!device->Flags.test(DevicePaused))
@@ -1822,6 +1952,13 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
             device->Frequency, device->UpdateSize, device->BufferSize);
     }
+    const auto reset_end = ResetClock::now();
+
+    TRACE("Reset took %.3fms: backend %.3fms, renderer %.3fms, output %.3fms, contexts "
+        "%.3fms, start %.3fms\n", stage_ms(reset_start, reset_end),
+        stage_ms(backend_start, backend_end), stage_ms(backend_end, renderer_end),
+        stage_ms(renderer_end, output_end), stage_ms(output_end, contexts_end),
+        stage_ms(contexts_end, reset_end));
 
     return ALC_NO_ERROR;
 }
@@ -1849,12 +1986,19 @@ bool ResetDeviceParams(ALCdevice *device, const al::span<const int> attrList)
              */
             std::lock_guard<std::mutex> sourcelock{ctx->mSourceLock};
             auto *vchg = ctx->mCurrentVoiceChange.load(std::memory_order_acquire);
+            size_t count{0};
             while(auto *next = vchg->mNext.load(std::memory_order_acquire))
+            {
                 vchg = next;
+                ++count;
+            }
             ctx->mCurrentVoiceChange.store(vchg, std::memory_order_release);
+            ctx->mVoiceChangeUsage.give(count);
 
             ctx->mVoicePropClusters.clear();
             ctx->mFreeVoiceProps.store(nullptr, std::memory_order_relaxed);
+            ctx->mVoicePropsUsage.mInUse.store(0u, std::memory_order_relaxed);
+            ctx->reserveProps();
 
             ctx->mVoiceClusters.clear();
             ctx->allocVoices(std::max<size_t>(256,
@@ -2435,6 +2579,18 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         values[0] = static_cast<ALCenum>(device->getOutputMode1());
         return 1;
 
+    case ALC_MIX_BLOCK_SIZE_SOFT:
+        values[0] = static_cast<int>(device->mMixBlockSize);
+        return 1;
+
+    case ALC_MIXER_PROFILING_SOFT:
+        values[0] = device->mProfile ? ALC_TRUE : ALC_FALSE;
+        return 1;
+
+    case ALC_MIXER_PROFILE_NUM_STAGES_SOFT:
+        values[0] = static_cast<int>(MixStageCount);
+        return 1;
+
     default:
         alcSetError(device, ALC_INVALID_ENUM);
     }
@@ -2569,6 +2725,55 @@ ALC_API void ALC_APIENTRY alcGetInteger64vSOFT(ALCdevice *device, ALCenum pname,
         valuespan[0] = GetClockLatency(dev.get(), dev->Backend.get()).Latency.count();
         break;
 
+    case ALC_MIXER_DEADLINE_MISSES_SOFT:
+        valuespan[0] = static_cast<ALCint64SOFT>(
+            dev->mDeadlineMisses.load(std::memory_order_relaxed));
+        break;
+
+    case ALC_MIXER_UNDERRUNS_SOFT:
+        valuespan[0] = static_cast<ALCint64SOFT>(dev->mUnderruns.load(std::memory_order_relaxed));
+        break;
+
+    case ALC_MIXER_PROFILE_STATS_SOFT:
+        if(valuespan.size() < MixStageCount*5)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else if(!dev->mProfile)
+            std::fill_n(valuespan.begin(), MixStageCount*5, ALCint64SOFT{0});
+        else
+        {
+            auto output = valuespan.begin();
+            for(size_t i{0};i < MixStageCount;++i)
+            {
+                const auto stats = dev->mProfile->summarize(static_cast<MixStage>(i));
+                *(output++) = static_cast<ALCint64SOFT>(stats.count);
+                *(output++) = static_cast<ALCint64SOFT>(stats.min);
+                *(output++) = static_cast<ALCint64SOFT>(stats.avg);
+                *(output++) = static_cast<ALCint64SOFT>(stats.p99);
+                *(output++) = static_cast<ALCint64SOFT>(stats.max);
+            }
+        }
+        break;
+
+    case ALC_CONTEXT_POOL_STATS_SOFT:
+        if(valuespan.size() < 4*3)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else if(ContextRef ctx{GetContextRef()}; !ctx || ctx->mALDevice.get() != dev.get())
+            alcSetError(dev.get(), ALC_INVALID_CONTEXT);
+        else
+        {
+            auto output = valuespan.begin();
+            for(const PoolUsage *usage : {&ctx->mVoiceChangeUsage, &ctx->mVoicePropsUsage,
+                &ctx->mEffectSlotPropsUsage, &ctx->mContextPropsUsage})
+            {
+                *(output++) = static_cast<ALCint64SOFT>(usage->inUse());
+                *(output++) = static_cast<ALCint64SOFT>(
+                    usage->mPeak.load(std::memory_order_relaxed));
+                *(output++) = static_cast<ALCint64SOFT>(
+                    usage->mExhausted.load(std::memory_order_relaxed));
+            }
+        }
+        break;
+
     case ALC_DEVICE_CLOCK_LATENCY_SOFT:
         if(size < 2)
             alcSetError(dev.get(), ALC_INVALID_VALUE);
@@ -2716,6 +2921,18 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
         alcSetError(dev.get(), ALC_OUT_OF_MEMORY);
         return nullptr;
     }
+
+    if(auto sizeopt = dev->configValue<uint>({}, "voice-changes"))
+        context->mVoiceChangeReserve = std::clamp(*sizeopt, 16u, 65536u);
+    if(auto sizeopt = dev->configValue<uint>({}, "voice-props"))
+        context->mVoicePropsReserve = std::min(*sizeopt, 65536u);
+    if(auto sizeopt = dev->configValue<uint>({}, "slot-props"))
+        context->mEffectSlotPropsReserve = std::min(*sizeopt, 4096u);
+    context->mFixedPools = dev->configValue<bool>({}, "fixed-pools").value_or(false);
+    TRACE("Reserving %zu voice changes, %zu voice props, %zu slot props%s\n",
+        context->mVoiceChangeReserve, context->mVoicePropsReserve,
+        context->mEffectSlotPropsReserve, context->mFixedPools ? " (fixed)" : "");
+
     context->init();
 
     if(auto volopt = dev->configValue<float>({}, "volume-adjust"))
@@ -2948,6 +3165,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcep
         auto backend = PlaybackFactory->createBackend(device.get(), BackendType::Playback);
         std::lock_guard<std::recursive_mutex> listlock{ListLock};
         backend->open(devname);
+        backend->applyOpenedProps();
         device->Backend = std::move(backend);
     }
     catch(al::backend_exception &e) {
@@ -3081,6 +3299,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcCaptureOpenDevice(const ALCchar *deviceName,
         auto backend = CaptureFactory->createBackend(device.get(), BackendType::Capture);
         std::lock_guard<std::recursive_mutex> listlock{ListLock};
         backend->open(devname);
+        backend->applyOpenedProps();
         device->Backend = std::move(backend);
     }
     catch(al::backend_exception &e) {
@@ -3255,6 +3474,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceN
         auto backend = LoopbackBackendFactory::getFactory().createBackend(device.get(),
             BackendType::Playback);
         backend->open("Loopback");
+        backend->applyOpenedProps();
         device->Backend = std::move(backend);
     }
     catch(al::backend_exception &e) {
@@ -3314,6 +3534,31 @@ ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffe
         device->renderSamples(buffer, static_cast<uint>(samples), device->channelsFromFmt());
 }
 
+/**
+ * Renders some samples into separate per-channel buffers, using the format
+ * last set by the attributes given to alcCreateContext. The number of buffers
+ * must match the number of channels for the format, and the samples are
+ * written directly to them without interleaving.
+ */
+#if defined(__GNUC__) && defined(__i386__)
+[[gnu::force_align_arg_pointer]]
+#endif
+ALC_API void ALC_APIENTRY alcRenderSamplesPlanarSOFT(ALCdevice *device, ALCvoid **buffers, ALCsizei samples) noexcept
+{
+    if(!device || device->Type != DeviceType::Loopback) UNLIKELY
+        alcSetError(device, ALC_INVALID_DEVICE);
+    else if(samples < 0 || (samples > 0 && buffers == nullptr)) UNLIKELY
+        alcSetError(device, ALC_INVALID_VALUE);
+    else if(samples > 0)
+    {
+        const auto outbufs = al::span{buffers, device->channelsFromFmt()};
+        if(std::any_of(outbufs.begin(), outbufs.end(), [](void *ptr) { return !ptr; })) UNLIKELY
+            alcSetError(device, ALC_INVALID_VALUE);
+        else
+            device->renderSamples(outbufs, static_cast<uint>(samples));
+    }
+}
+
 
 /************************************************
  * ALC DSP pause/resume functions
@@ -3468,18 +3713,32 @@ FORCE_ALIGN ALCboolean ALC_APIENTRY alcReopenDeviceSOFT(ALCdevice *device,
             devname = {};
     }
 
-    /* Force the backend device to stop first since we're opening another one. */
+    /* Open the new backend device while the old one keeps playing, so the
+     * output is only interrupted for the reset. Some devices can't be opened
+     * again while in use, so if that fails, try again with the old one
+     * stopped.
+     */
     const bool wasPlaying{dev->mDeviceState == DeviceState::Playing};
-    if(wasPlaying)
+    auto open_backend = [&dev,devname]
     {
-        dev->Backend->stop();
-        dev->mDeviceState = DeviceState::Configured;
-    }
+        BackendPtr backend{PlaybackFactory->createBackend(dev.get(), BackendType::Playback)};
+        backend->open(devname);
+        return backend;
+    };
 
     BackendPtr newbackend;
     try {
-        newbackend = PlaybackFactory->createBackend(dev.get(), BackendType::Playback);
-        newbackend->open(devname);
+        try {
+            newbackend = open_backend();
+        }
+        catch(al::backend_exception &e) {
+            if(!wasPlaying) throw;
+
+            WARN("Failed to open playback device while playing: %s\n", e.what());
+            dev->Backend->stop();
+            dev->mDeviceState = DeviceState::Configured;
+            newbackend = open_backend();
+        }
     }
     catch(al::backend_exception &e) {
         listlock.unlock();
@@ -3489,7 +3748,8 @@ FORCE_ALIGN ALCboolean ALC_APIENTRY alcReopenDeviceSOFT(ALCdevice *device,
         alcSetError(dev.get(), (e.errorCode() == al::backend_error::OutOfMemory)
             ? ALC_OUT_OF_MEMORY : ALC_INVALID_VALUE);
 
-        if(dev->Connected.load(std::memory_order_relaxed) && wasPlaying)
+        if(dev->Connected.load(std::memory_order_relaxed) && wasPlaying
+            && dev->mDeviceState != DeviceState::Playing)
         {
             try {
                 auto backend = dev->Backend.get();
@@ -3504,8 +3764,17 @@ FORCE_ALIGN ALCboolean ALC_APIENTRY alcReopenDeviceSOFT(ALCdevice *device,
         return ALC_FALSE;
     }
     listlock.unlock();
-    dev->Backend = std::move(newbackend);
+
+    const auto switch_start = std::chrono::steady_clock::now();
+    if(dev->mDeviceState == DeviceState::Playing)
+        dev->Backend->stop();
+    const auto stop_end = std::chrono::steady_clock::now();
+    /* Hold on to the old backend until the new one is started, since closing
+     * it can take a while.
+     */
+    BackendPtr oldbackend{std::exchange(dev->Backend, std::move(newbackend))};
     dev->mDeviceState = DeviceState::Unprepared;
+    dev->Backend->applyOpenedProps();
     TRACE("Reopened device %p, \"%s\"\n", voidp{dev.get()}, dev->DeviceName.c_str());
 
     /* Always return true even if resetting fails. It shouldn't fail, but this
@@ -3520,6 +3789,20 @@ FORCE_ALIGN ALCboolean ALC_APIENTRY alcReopenDeviceSOFT(ALCdevice *device,
      * immediately disconnects following it.
      */
     ResetDeviceParams(dev.get(), SpanFromAttributeList(attribs));
+    if(wasPlaying)
+    {
+        using std::chrono::duration;
+        TRACE("Output interrupted for %.3fms (%.3fms stopping the old device)\n",
+            duration<double,std::milli>(std::chrono::steady_clock::now()-switch_start).count(),
+            duration<double,std::milli>(stop_end-switch_start).count());
+    }
+
+    /* The old backend is closed here rather than handed off to another thread,
+     * since its destructor may still access the device, which the app is free
+     * to close once this returns. The new backend is already playing, so this
+     * only delays the return, not the output.
+     */
+    oldbackend = nullptr;
     return ALC_TRUE;
 }
 
@@ -40,6 +40,10 @@
 #include <optional>
 #include <utility>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 #include "almalloc.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -50,15 +54,13 @@
 #include "core/async_event.h"
 #include "core/bformatdec.h"
 #include "core/bs2b.h"
-#include "core/bsinc_defs.h"
-#include "core/bsinc_tables.h"
 #include "core/bufferline.h"
 #include "core/buffer_storage.h"
 #include "core/context.h"
 #include "core/cpu_caps.h"
-#include "core/cubic_tables.h"
 #include "core/devformat.h"
 #include "core/device.h"
+#include "core/effect_threads.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/filters/biquad.h"
@@ -84,20 +86,9 @@ struct CTag;
 #ifdef HAVE_SSE
 struct SSETag;
 #endif
-#ifdef HAVE_SSE2
-struct SSE2Tag;
-#endif
-#ifdef HAVE_SSE4_1
-struct SSE4Tag;
-#endif
 #ifdef HAVE_NEON
 struct NEONTag;
 #endif
-struct PointTag;
-struct LerpTag;
-struct CubicTag;
-struct BSincTag;
-struct FastBSincTag;
 
 
 static_assert(!(MaxResamplerPadding&1), "MaxResamplerPadding is not a multiple of two");
@@ -156,99 +147,6 @@ inline HrtfDirectMixerFunc SelectHrtfMixer()
 }
 
 
-inline void BsincPrepare(const uint increment, BsincState *state, const BSincTable *table)
-{
-    size_t si{BSincScaleCount - 1};
-    float sf{0.0f};
-
-    if(increment > MixerFracOne)
-    {
-        sf = MixerFracOne/static_cast<float>(increment) - table->scaleBase;
-        sf = std::max(0.0f, BSincScaleCount*sf*table->scaleRange - 1.0f);
-        si = float2uint(sf);
-        /* The interpolation factor is fit to this diagonally-symmetric curve
-         * to reduce the transition ripple caused by interpolating different
-         * scales of the sinc function.
-         */
-        sf = 1.0f - std::cos(std::asin(sf - static_cast<float>(si)));
-    }
-
-    state->sf = sf;
-    state->m = table->m[si];
-    state->l = (state->m/2) - 1;
-    state->filter = table->Tab.subspan(table->filterOffset[si]);
-}
-
-inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
-{
-    switch(resampler)
-    {
-    case Resampler::Point:
-        return Resample_<PointTag,CTag>;
-    case Resampler::Linear:
-#ifdef HAVE_NEON
-        if((CPUCapFlags&CPU_CAP_NEON))
-            return Resample_<LerpTag,NEONTag>;
-#endif
-#ifdef HAVE_SSE4_1
-        if((CPUCapFlags&CPU_CAP_SSE4_1))
-            return Resample_<LerpTag,SSE4Tag>;
-#endif
-#ifdef HAVE_SSE2
-        if((CPUCapFlags&CPU_CAP_SSE2))
-            return Resample_<LerpTag,SSE2Tag>;
-#endif
-        return Resample_<LerpTag,CTag>;
-    case Resampler::Spline:
-    case Resampler::Gaussian:
-#ifdef HAVE_NEON
-        if((CPUCapFlags&CPU_CAP_NEON))
-            return Resample_<CubicTag,NEONTag>;
-#endif
-#ifdef HAVE_SSE4_1
-        if((CPUCapFlags&CPU_CAP_SSE4_1))
-            return Resample_<CubicTag,SSE4Tag>;
-#endif
-#ifdef HAVE_SSE2
-        if((CPUCapFlags&CPU_CAP_SSE2))
-            return Resample_<CubicTag,SSE2Tag>;
-#endif
-#ifdef HAVE_SSE
-        if((CPUCapFlags&CPU_CAP_SSE))
-            return Resample_<CubicTag,SSETag>;
-#endif
-        return Resample_<CubicTag,CTag>;
-    case Resampler::BSinc12:
-    case Resampler::BSinc24:
-        if(increment > MixerFracOne)
-        {
-#ifdef HAVE_NEON
-            if((CPUCapFlags&CPU_CAP_NEON))
-                return Resample_<BSincTag,NEONTag>;
-#endif
-#ifdef HAVE_SSE
-            if((CPUCapFlags&CPU_CAP_SSE))
-                return Resample_<BSincTag,SSETag>;
-#endif
-            return Resample_<BSincTag,CTag>;
-        }
-        /* fall-through */
-    case Resampler::FastBSinc12:
-    case Resampler::FastBSinc24:
-#ifdef HAVE_NEON
-        if((CPUCapFlags&CPU_CAP_NEON))
-            return Resample_<FastBSincTag,NEONTag>;
-#endif
-#ifdef HAVE_SSE
-        if((CPUCapFlags&CPU_CAP_SSE))
-            return Resample_<FastBSincTag,SSETag>;
-#endif
-        return Resample_<FastBSincTag,CTag>;
-    }
-
-    return Resample_<PointTag,CTag>;
-}
-
 } // namespace
 
 void aluInit(CompatFlagBitset flags, const float nfcscale)
@@ -262,32 +160,6 @@ void aluInit(CompatFlagBitset flags, const float nfcscale)
 }
 
 
-ResamplerFunc PrepareResampler(Resampler resampler, uint increment, InterpState *state)
-{
-    switch(resampler)
-    {
-    case Resampler::Point:
-    case Resampler::Linear:
-        break;
-    case Resampler::Spline:
-        state->emplace<CubicState>(al::span{gSplineFilter.mTable});
-        break;
-    case Resampler::Gaussian:
-        state->emplace<CubicState>(al::span{gGaussianFilter.mTable});
-        break;
-    case Resampler::FastBSinc12:
-    case Resampler::BSinc12:
-        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc12);
-        break;
-    case Resampler::FastBSinc24:
-    case Resampler::BSinc24:
-        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc24);
-        break;
-    }
-    return SelectResampler(resampler, increment);
-}
-
-
 void DeviceBase::ProcessHrtf(const size_t SamplesToDo)
 {
     /* HRTF is stereo output only. */
@@ -340,14 +212,19 @@ void DeviceBase::ProcessBs2b(const size_t SamplesToDo)
 
 namespace {
 
-/* This RNG method was created based on the math found in opusdec. It's quick,
- * and starting with a seed value of 22222, is suitable for generating
- * whitenoise.
+/* Counter-based RNG for dithering. Each value is an integer hash of its
+ * position in the sequence (the "lowbias32" hash by Chris Wellons), so any
+ * number of values can be generated independently, rather than serially
+ * depending on the previous value.
  */
-inline uint dither_rng(uint *seed) noexcept
+constexpr uint dither_rng(uint counter) noexcept
 {
-    *seed = (*seed * 96314165) + 907633515;
-    return *seed;
+    counter ^= counter >> 16;
+    counter *= 0x7feb352du;
+    counter ^= counter >> 15;
+    counter *= 0x846ca68bu;
+    counter ^= counter >> 16;
+    return counter;
 }
 
 
@@ -444,6 +321,7 @@ bool CalcContextParams(ContextBase *ctx)
     ctx->mParams.mDistanceModel = props->mDistanceModel;
 
     AtomicReplaceHead(ctx->mFreeContextProps, props);
+    ctx->mContextPropsUsage.give();
     return true;
 }
 
@@ -460,6 +338,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
     slot->Gain = props->Gain;
     slot->AuxSendAuto = props->AuxSendAuto;
     slot->Target = props->Target;
+    slot->DeviceBus = props->DeviceBus;
     slot->EffectType = props->Type;
     slot->mEffectProps = props->Props;
     if(auto *reverbprops = std::get_if<ReverbProps>(&props->Props))
@@ -511,6 +390,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
     }
 
     AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+    context->mEffectSlotPropsUsage.give();
 
     const auto output = [slot,context]() -> EffectTarget
     {
@@ -1453,6 +1333,41 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
     }
 }
 
+/* Gets the slot that takes the input sent to the given slot, which is the
+ * owner of the device bus it's on, if any.
+ */
+EffectSlot *GetInputSlot(const DeviceBase *device, EffectSlot *slot) noexcept
+{
+    if(slot && slot->DeviceBus > 0)
+    {
+        if(EffectSlot *busslot{device->mMixBusSlots[slot->DeviceBus-1]})
+            return busslot;
+    }
+    return slot;
+}
+
+/* Points the voice's sends at the current input slots, for when the device
+ * bus owners change. This leaves the send gains, and any pending property
+ * update, for the next full update.
+ */
+void UpdateBusSends(Voice *voice, const DeviceBase *device) noexcept
+{
+    for(uint i{0};i < device->NumAuxSends;i++)
+    {
+        EffectSlot *slot{GetInputSlot(device, voice->mProps.Send[i].Slot)};
+        if(!slot || slot->EffectType == EffectSlotType::None)
+        {
+            voice->mSend[i].Buffer = {};
+            voice->mSend[i].Slot = nullptr;
+        }
+        else
+        {
+            voice->mSend[i].Buffer = slot->Wet.Buffer;
+            voice->mSend[i].Slot = slot;
+        }
+    }
+}
+
 void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context)
 {
     DeviceBase *Device{context->mDevice};
@@ -1461,14 +1376,18 @@ void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const Contex
     voice->mDirect.Buffer = Device->Dry.Buffer;
     for(uint i{0};i < Device->NumAuxSends;i++)
     {
-        SendSlots[i] = props->Send[i].Slot;
+        SendSlots[i] = GetInputSlot(Device, props->Send[i].Slot);
         if(!SendSlots[i] || SendSlots[i]->EffectType == EffectSlotType::None)
         {
             SendSlots[i] = nullptr;
             voice->mSend[i].Buffer = {};
+            voice->mSend[i].Slot = nullptr;
         }
         else
+        {
             voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            voice->mSend[i].Slot = SendSlots[i];
+        }
     }
 
     /* Calculate the stepping value */
@@ -1512,7 +1431,7 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
     std::bitset<MaxSendCount> UseDryAttnForRoom{0};
     for(uint i{0};i < NumSends;i++)
     {
-        SendSlots[i] = props->Send[i].Slot;
+        SendSlots[i] = GetInputSlot(Device, props->Send[i].Slot);
         if(!SendSlots[i] || SendSlots[i]->EffectType == EffectSlotType::None)
             SendSlots[i] = nullptr;
         else if(SendSlots[i]->AuxSendAuto)
@@ -1533,9 +1452,15 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
             UseDryAttnForRoom.set(i);
 
         if(!SendSlots[i])
+        {
             voice->mSend[i].Buffer = {};
+            voice->mSend[i].Slot = nullptr;
+        }
         else
+        {
             voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            voice->mSend[i].Slot = SendSlots[i];
+        }
     }
 
     /* Transform source to listener space (convert to head relative) */
@@ -1798,6 +1723,7 @@ void CalcSourceParams(Voice *voice, ContextBase *context, bool force)
         voice->mProps = static_cast<VoiceProps&>(*props);
 
         AtomicReplaceHead(context->mFreeVoiceProps, props);
+        context->mVoicePropsUsage.give();
     }
 
     if((voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
@@ -1834,6 +1760,9 @@ void SendSourceStateEvent(ContextBase *context, uint id, VChangeState state)
         break;
     /* Shouldn't happen. */
     case VChangeState::Restart:
+    case VChangeState::StopAt:
+    case VChangeState::PauseAt:
+    case VChangeState::GainRamp:
         al::unreachable();
     }
 
@@ -1847,8 +1776,10 @@ void ProcessVoiceChanges(ContextBase *ctx)
     if(!next) return;
 
     const auto enabledevt = ctx->mEnabledEvts.load(std::memory_order_acquire);
+    size_t count{0};
     do {
         cur = next;
+        ++count;
 
         bool sendevt{false};
         if(cur->mState == VChangeState::Reset || cur->mState == VChangeState::Stop)
@@ -1865,6 +1796,7 @@ void ProcessVoiceChanges(ContextBase *ctx)
                 voice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                     std::memory_order_relaxed, std::memory_order_acquire);
                 voice->mPendingChange.store(false, std::memory_order_release);
+                ctx->addFreeVoice(voice);
             }
             /* Reset state change events are always sent, even if the voice is
              * already stopped or even if there is no voice.
@@ -1874,6 +1806,8 @@ void ProcessVoiceChanges(ContextBase *ctx)
         else if(cur->mState == VChangeState::Pause)
         {
             Voice *voice{cur->mVoice};
+            /* Pausing cancels a scheduled stop. */
+            voice->mStopTime = nanoseconds::max();
             Voice::State oldvstate{Voice::Playing};
             sendevt = voice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                 std::memory_order_release, std::memory_order_acquire);
@@ -1895,12 +1829,14 @@ void ProcessVoiceChanges(ContextBase *ctx)
                 sendevt = !oldvoice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                     std::memory_order_relaxed, std::memory_order_acquire);
                 oldvoice->mPendingChange.store(false, std::memory_order_release);
+                ctx->addFreeVoice(oldvoice);
             }
             else
                 sendevt = true;
 
             Voice *voice{cur->mVoice};
             voice->mPlayState.store(Voice::Playing, std::memory_order_release);
+            ctx->addMixVoice(voice);
         }
         else if(cur->mState == VChangeState::Restart)
         {
@@ -1908,6 +1844,19 @@ void ProcessVoiceChanges(ContextBase *ctx)
             Voice *oldvoice{cur->mOldVoice};
             oldvoice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
             oldvoice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
+            /* The new voice has a source either way, so it needs processing
+             * until the source lets it go.
+             */
+            Voice *voice{cur->mVoice};
+            voice->mStopTime = oldvoice->mStopTime;
+            voice->mStopPauses = oldvoice->mStopPauses;
+            voice->mMixerPaused.store(oldvoice->mMixerPaused.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+            voice->mRampGain = oldvoice->mRampGain;
+            voice->mRampTarget = oldvoice->mRampTarget;
+            voice->mRampStart = oldvoice->mRampStart;
+            voice->mRampEnd = oldvoice->mRampEnd;
+            ctx->addMixVoice(voice);
             /* If there's no sourceID, the old voice finished so don't start
              * the new one at its new offset.
              */
@@ -1921,11 +1870,37 @@ void ProcessVoiceChanges(ContextBase *ctx)
                 oldvoice->mPlayState.compare_exchange_strong(oldvstate, Voice::Stopping,
                     std::memory_order_relaxed, std::memory_order_acquire);
 
-                Voice *voice{cur->mVoice};
                 voice->mPlayState.store((oldvstate == Voice::Playing) ? Voice::Playing
                     : Voice::Stopped, std::memory_order_release);
             }
             oldvoice->mPendingChange.store(false, std::memory_order_release);
+            ctx->addFreeVoice(oldvoice);
+        }
+        else if(cur->mState == VChangeState::StopAt || cur->mState == VChangeState::PauseAt)
+        {
+            /* The state changes (and the event is sent) when the voice gets
+             * to the scheduled time, if it's still playing for the source.
+             */
+            Voice *voice{cur->mVoice};
+            if(voice->mSourceID.load(std::memory_order_relaxed) == cur->mSourceID)
+            {
+                voice->mStopTime = cur->mTime;
+                voice->mStopPauses = (cur->mState == VChangeState::PauseAt);
+            }
+            voice->mPendingChange.store(false, std::memory_order_release);
+            ctx->addFreeVoice(voice);
+        }
+        else if(cur->mState == VChangeState::GainRamp)
+        {
+            /* A new ramp replaces the one in progress, starting from the gain
+             * it's at now.
+             */
+            Voice *voice{cur->mVoice};
+            if(voice->mSourceID.load(std::memory_order_relaxed) == cur->mSourceID)
+                voice->setRampGain(ctx->mDevice->getClockTime(), cur->mGain, cur->mTime,
+                    cur->mEndTime);
+            voice->mPendingChange.store(false, std::memory_order_release);
+            ctx->addFreeVoice(voice);
         }
         if(sendevt && enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
             SendSourceStateEvent(ctx, cur->mSourceID, cur->mState);
@@ -1933,63 +1908,265 @@ void ProcessVoiceChanges(ContextBase *ctx)
         next = cur->mNext.load(std::memory_order_acquire);
     } while(next);
     ctx->mCurrentVoiceChange.store(cur, std::memory_order_release);
+    ctx->mVoiceChangeUsage.give(count);
 }
 
 void ProcessParamUpdates(ContextBase *ctx, const al::span<EffectSlot*> slots,
-    const al::span<EffectSlot*> sorted_slots, const al::span<Voice*> voices)
+    const al::span<EffectSlot*> sorted_slots, const bool newblock, const bool buseschanged)
 {
-    ProcessVoiceChanges(ctx);
+    /* Passes after the first in a mixing block leave updates for the next
+     * block, except for bus send targets.
+     */
+    if(!newblock && !buseschanged)
+        return;
+    if(newblock)
+        ProcessVoiceChanges(ctx);
 
     IncrementRef(ctx->mUpdateCount);
-    if(!ctx->mHoldUpdates.load(std::memory_order_acquire)) LIKELY
+    const bool holdupdates{!newblock || ctx->mHoldUpdates.load(std::memory_order_acquire)};
+    if(!holdupdates) LIKELY
     {
-        bool force{CalcContextParams(ctx)};
+        bool force{CalcContextParams(ctx) || buseschanged};
         auto sorted_slot_base = al::to_address(sorted_slots.begin());
         for(EffectSlot *slot : slots)
             force |= CalcEffectSlotParams(slot, sorted_slot_base, ctx);
 
-        for(Voice *voice : voices)
+        for(Voice *voice : ctx->getMixVoices())
         {
             /* Only update voices that have a source. */
             if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
                 CalcSourceParams(voice, ctx, force);
         }
     }
+    if(buseschanged) UNLIKELY
+    {
+        /* Voices sending to a device bus hold on to the owner's mixing buffer,
+         * and an old owner may be going away. Voices that weren't updated
+         * above, because updates are held or they're stopping without a
+         * source, still need to send to the current owners.
+         */
+        for(Voice *voice : ctx->getMixVoices())
+        {
+            if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped)
+                continue;
+            if(holdupdates || voice->mSourceID.load(std::memory_order_relaxed) == 0)
+                UpdateBusSends(voice, ctx->mDevice);
+        }
+    }
     IncrementRef(ctx->mUpdateCount);
 }
 
-void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
+
+/* Checks if the effect slot needs processing for this update. Slots that have
+ * had no input for longer than the effect's tail are skipped, since they'd
+ * only produce silence.
+ */
+bool CheckSlotActive(EffectSlot *slot, const uint SamplesToDo) noexcept
+{
+    const uint taillen{slot->mEffectState->mTailLength};
+    if(slot->mHasInput)
+        slot->mSilentSamples = 0;
+    else if(slot->mSilentSamples >= taillen)
+        return false;
+    else
+        slot->mSilentSamples += std::min(SamplesToDo, taillen - slot->mSilentSamples);
+    return true;
+}
+
+/* Reorders the topologically sorted slots by level, where each slot's level
+ * is one more than the highest level of the slots targeting it. Slots on the
+ * same level don't depend on each other, so can be processed together. The
+ * slots keep their relative order within a level, and this is done whenever
+ * the slots are re-sorted regardless of the effect threads, so the levels stay
+ * valid if the threads are started or stopped later.
+ */
+void SortSlotLevels(const al::span<EffectSlot*> sorted_slots)
+{
+    for(EffectSlot *slot : sorted_slots)
+        slot->mGraphLevel = 0;
+    /* Sources come before their targets, so each slot's level is final by the
+     * time it's visited.
+     */
+    for(EffectSlot *slot : sorted_slots)
+    {
+        if(EffectSlot *target{slot->Target})
+            target->mGraphLevel = std::max(target->mGraphLevel, slot->mGraphLevel+1);
+    }
+    /* There's only a handful of slots, so a simple insertion sort does, and
+     * it doesn't allocate like std::stable_sort may.
+     */
+    auto level_less = [](const EffectSlot *lhs, const EffectSlot *rhs) noexcept -> bool
+    { return lhs->mGraphLevel < rhs->mGraphLevel; };
+    for(auto iter = sorted_slots.begin();iter != sorted_slots.end();++iter)
+        std::rotate(std::upper_bound(sorted_slots.begin(), iter, *iter, level_less), iter,
+            iter+1);
+}
+
+/* Processes the slots marked for processing, which must not depend on each
+ * other, across the effect threads.
+ */
+void ProcessActiveSlots(EffectThreadPool &pool, const al::span<EffectSlot*> slots,
+    const size_t numactive, const uint SamplesToDo)
+{
+    /* A lone slot doesn't need the threads, or its own output buffer. */
+    if(numactive < 2)
+    {
+        for(EffectSlot *slot : slots)
+        {
+            if(!slot->mProcessing) continue;
+            EffectState *state{slot->mEffectState.get()};
+            state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+            if(slot->Target)
+                slot->Target->mHasInput = true;
+        }
+        return;
+    }
+
+    /* A slot's private output buffer is sized with its wet buffer, which won't
+     * have happened if the threads were started after it was set up. Such a
+     * slot is processed directly to its target here, which none of the other
+     * slots on this level read from.
+     */
+    for(EffectSlot *slot : slots)
+    {
+        if(!slot->mProcessing) continue;
+        EffectState *state{slot->mEffectState.get()};
+        if(slot->mOutBuffer.size() >= state->mOutTarget.size()) LIKELY
+            continue;
+
+        state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+        if(slot->Target)
+            slot->Target->mHasInput = true;
+        slot->mProcessing = false;
+    }
+
+    pool.run(slots.size(), [slots,SamplesToDo](const size_t idx)
+    {
+        EffectSlot *slot{slots[idx]};
+        if(!slot->mProcessing) return;
+
+        EffectState *state{slot->mEffectState.get()};
+        const auto output = al::span{slot->mOutBuffer}.first(state->mOutTarget.size());
+        for(FloatBufferLine &buffer : output)
+            std::fill_n(buffer.begin(), SamplesToDo, 0.0f);
+        state->process(SamplesToDo, slot->Wet.Buffer, output);
+    });
+
+    /* Mix the outputs to their targets in slot order, so the result doesn't
+     * depend on which thread finished first.
+     */
+    for(EffectSlot *slot : slots)
+    {
+        if(!slot->mProcessing) continue;
+
+        const auto target = slot->mEffectState->mOutTarget;
+        auto output = slot->mOutBuffer.cbegin();
+        for(FloatBufferLine &buffer : target)
+        {
+            std::transform(output->cbegin(), output->cbegin()+SamplesToDo, buffer.cbegin(),
+                buffer.begin(), std::plus<float>{});
+            ++output;
+        }
+        if(slot->Target)
+            slot->Target->mHasInput = true;
+    }
+}
+
+/* Processes one level of effect slots using the effect threads. */
+void ProcessSlotLevel(EffectThreadPool &pool, const al::span<EffectSlot*> slots,
+    const uint SamplesToDo)
+{
+    size_t numactive{0};
+    for(EffectSlot *slot : slots)
+    {
+        slot->mProcessing = !slot->mOnDeviceBus && CheckSlotActive(slot, SamplesToDo);
+        numactive += slot->mProcessing ? 1u : 0u;
+    }
+    ProcessActiveSlots(pool, slots, numactive, SamplesToDo);
+}
+
+template<bool Profiled>
+void ProcessContexts(DeviceBase *device, const uint SamplesToDo, const bool NewBlock)
 {
     ASSUME(SamplesToDo > 0);
 
+    [[maybe_unused]] MixerProfile *profile{Profiled ? device->mProfile.get() : nullptr};
+
     const nanoseconds curtime{device->mClockBase.load(std::memory_order_relaxed) +
         nanoseconds{seconds{device->mSamplesDone.load(std::memory_order_relaxed)}}/
         device->Frequency};
 
+    /* Get the device bus owners for this update. They take input from every
+     * context, so they're cleared before any context mixes and processed
+     * after they all have.
+     */
+    const auto busslots = al::span{device->mMixBusSlots};
+    bool buseschanged{false};
+    for(size_t i{0};i < busslots.size();++i)
+    {
+        EffectSlot *slot{device->mBusSlots[i].load(std::memory_order_acquire)};
+        buseschanged |= std::exchange(busslots[i], slot) != slot;
+        if(slot && std::exchange(slot->mHasInput, false))
+        {
+            for(auto &buffer : slot->Wet.Buffer)
+                buffer.fill(0.0f);
+        }
+    }
+    auto on_device_bus = [busslots](const EffectSlot *slot) noexcept -> bool
+    {
+        if(slot->DeviceBus > 0 && busslots[slot->DeviceBus-1] != nullptr)
+            return true;
+        return std::find(busslots.begin(), busslots.end(), slot) != busslots.end();
+    };
+
     for(ContextBase *ctx : *device->mContexts.load(std::memory_order_acquire))
     {
         const auto auxslotspan = al::span{*ctx->mActiveAuxSlots.load(std::memory_order_acquire)};
         const auto auxslots = auxslotspan.first(auxslotspan.size()>>1);
         const auto sorted_slots = auxslotspan.last(auxslotspan.size()>>1);
-        const al::span<Voice*> voices{ctx->getVoicesSpanAcquired()};
 
         /* Process pending property updates for objects on the context. */
-        ProcessParamUpdates(ctx, auxslots, sorted_slots, voices);
+        if constexpr(Profiled) profile->mark();
+        ProcessParamUpdates(ctx, auxslots, sorted_slots, NewBlock, buseschanged);
+        if constexpr(Profiled) profile->lap(MixStage::ParamUpdates);
 
-        /* Clear auxiliary effect slot mixing buffers. */
+        /* Clear auxiliary effect slot mixing buffers. Buffers that got no
+         * input last update are still clear, and slots on a device bus are
+         * left to the device.
+         */
         for(EffectSlot *slot : auxslots)
         {
+            slot->mOnDeviceBus = on_device_bus(slot);
+            if(slot->mOnDeviceBus || !std::exchange(slot->mHasInput, false))
+                continue;
             for(auto &buffer : slot->Wet.Buffer)
                 buffer.fill(0.0f);
         }
 
-        /* Process voices that have a playing source. */
+        /* Process voices that have a playing source. Voices that are stopped
+         * with no source are dropped from the list, keeping the order of the
+         * rest, and returned to the free list.
+         */
+        const auto voices = ctx->getMixVoices();
+        auto voice_end = voices.begin();
         for(Voice *voice : voices)
         {
-            const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
+            Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
             if(vstate != Voice::Stopped && vstate != Voice::Pending)
+            {
                 voice->mix(vstate, ctx, curtime, SamplesToDo);
+                vstate = voice->mPlayState.load(std::memory_order_relaxed);
+            }
+            if(vstate == Voice::Stopped && voice->mSourceID.load(std::memory_order_relaxed) == 0u)
+            {
+                voice->mInMixList = false;
+                ctx->addFreeVoice(voice);
+                continue;
+            }
+            *(voice_end++) = voice;
         }
+        ctx->trimMixVoices(static_cast<size_t>(std::distance(voices.begin(), voice_end)));
+        if constexpr(Profiled) profile->lap(MixStage::Voices);
 
         /* Process effects. */
         if(!auxslots.empty())
@@ -2040,19 +2217,82 @@ void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
                             { return slot->Target != *next_target; });
                     } while(split_point - sorted_slots.begin() > 1);
                 }
+
+                SortSlotLevels(sorted_slots);
             }
 
-            for(const EffectSlot *slot : sorted_slots)
+            if constexpr(Profiled) profile->mark();
+            if(EffectThreadPool *pool{device->mEffectThreads.get()}; pool && sorted_slots.size() > 1)
             {
-                EffectState *state{slot->mEffectState.get()};
-                state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+                /* Process each level of slots in turn, with the slots in a
+                 * level spread across the effect threads.
+                 */
+                size_t level_start{0};
+                while(level_start < sorted_slots.size())
+                {
+                    const uint level{sorted_slots[level_start]->mGraphLevel};
+                    const auto level_end = std::find_if(sorted_slots.begin()+level_start+1,
+                        sorted_slots.end(), [level](const EffectSlot *slot) noexcept -> bool
+                        { return slot->mGraphLevel != level; });
+                    const auto level_count = static_cast<size_t>(level_end -
+                        (sorted_slots.begin()+level_start));
+
+                    ProcessSlotLevel(*pool, sorted_slots.subspan(level_start, level_count),
+                        SamplesToDo);
+                    if constexpr(Profiled) profile->lap(MixStage::Effects);
+                    level_start += level_count;
+                }
+            }
+            else
+            {
+                for(EffectSlot *slot : sorted_slots)
+                {
+                    if(slot->mOnDeviceBus || !CheckSlotActive(slot, SamplesToDo))
+                        continue;
+
+                    EffectState *state{slot->mEffectState.get()};
+                    state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+                    if(slot->Target)
+                        slot->Target->mHasInput = true;
+                    if constexpr(Profiled) profile->lap(MixStage::Effects);
+                }
             }
         }
 
         /* Signal the event handler if there are any events to read. */
         RingBuffer *ring{ctx->mAsyncEvents.get()};
         if(ring->readSpace() > 0)
-            ctx->mEventSem.post();
+            ctx->signalEvents();
+    }
+
+    /* Process the device buses, now that every context has mixed into them.
+     * They output straight to the device, so don't depend on each other.
+     */
+    std::array<EffectSlot*,MaxDeviceBuses> activebuses{};
+    size_t numactive{0};
+    for(EffectSlot *slot : busslots)
+    {
+        if(slot && CheckSlotActive(slot, SamplesToDo))
+        {
+            slot->mProcessing = true;
+            activebuses[numactive++] = slot;
+        }
+    }
+    if(numactive > 0)
+    {
+        if constexpr(Profiled) profile->mark();
+        const auto buses = al::span{activebuses}.first(numactive);
+        if(EffectThreadPool *pool{device->mEffectThreads.get()})
+            ProcessActiveSlots(*pool, buses, numactive, SamplesToDo);
+        else
+        {
+            for(EffectSlot *slot : buses)
+            {
+                EffectState *state{slot->mEffectState.get()};
+                state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+            }
+        }
+        if constexpr(Profiled) profile->lap(MixStage::Effects);
     }
 }
 
@@ -2089,28 +2329,89 @@ void ApplyDistanceComp(const al::span<FloatBufferLine> Samples, const size_t Sam
     }
 }
 
+#ifdef HAVE_SSE_INTRINSICS
+/* SSE2 lacks a 32-bit multiply keeping the low bits, so emulate it with two
+ * 32x32->64-bit multiplies.
+ */
+inline __m128i mullo_epi32(const __m128i a, const __m128i b) noexcept
+{
+    const __m128i even{_mm_mul_epu32(a, b)};
+    const __m128i odd{_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32))};
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+}
+
+inline __m128i dither_rng4(__m128i counter) noexcept
+{
+    counter = _mm_xor_si128(counter, _mm_srli_epi32(counter, 16));
+    counter = mullo_epi32(counter, _mm_set1_epi32(0x7feb352d));
+    counter = _mm_xor_si128(counter, _mm_srli_epi32(counter, 15));
+    counter = mullo_epi32(counter, _mm_set1_epi32(static_cast<int>(0x846ca68bu)));
+    counter = _mm_xor_si128(counter, _mm_srli_epi32(counter, 16));
+    return counter;
+}
+#endif
+
 void ApplyDither(const al::span<FloatBufferLine> Samples, uint *dither_seed,
     const float quant_scale, const size_t SamplesToDo)
 {
-    static constexpr double invRNGRange{1.0 / std::numeric_limits<uint>::max()};
+    /* Only the top 24 bits of each random value are used, so they convert to
+     * float exactly.
+     */
+    static constexpr float invRNGRange{1.0f / 16777216.0f};
     ASSUME(SamplesToDo > 0);
 
     /* Dithering. Generate whitenoise (uniform distribution of random values
      * between -1 and +1) and add it to the sample values, after scaling up to
-     * the desired quantization depth and before rounding.
+     * the desired quantization depth and before rounding. Each sample uses two
+     * consecutive values from the RNG sequence, making a triangular
+     * distribution.
      */
     const float invscale{1.0f / quant_scale};
     uint seed{*dither_seed};
-    auto dither_sample = [&seed,invscale,quant_scale](const float sample) noexcept -> float
-    {
-        float val{sample * quant_scale};
-        uint rng0{dither_rng(&seed)};
-        uint rng1{dither_rng(&seed)};
-        val += static_cast<float>(rng0*invRNGRange - rng1*invRNGRange);
-        return fast_roundf(val) * invscale;
-    };
     for(FloatBufferLine &inout : Samples)
-        std::transform(inout.begin(), inout.begin()+SamplesToDo, inout.begin(), dither_sample);
+    {
+        const auto line = al::span{al::assume_aligned<16>(inout.data()), SamplesToDo};
+        size_t base{0};
+#ifdef HAVE_SSE_INTRINSICS
+        const __m128 scale4{_mm_set1_ps(quant_scale)};
+        const __m128 invscale4{_mm_set1_ps(invscale)};
+        const __m128 invrange4{_mm_set1_ps(invRNGRange)};
+        /* Counters for the first value of samples [0...3] are seed+[0,2,4,6],
+         * and the second values are one more.
+         */
+        __m128i counter{_mm_add_epi32(_mm_set1_epi32(static_cast<int>(seed)),
+            _mm_setr_epi32(0, 2, 4, 6))};
+        for(;SamplesToDo-base >= 4;base += 4)
+        {
+            const __m128i rng0{_mm_srli_epi32(dither_rng4(counter), 8)};
+            const __m128i rng1{_mm_srli_epi32(dither_rng4(_mm_add_epi32(counter,
+                _mm_set1_epi32(1))), 8)};
+            const __m128 noise{_mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(rng0, rng1)),
+                invrange4)};
+            __m128 val{_mm_add_ps(_mm_mul_ps(_mm_load_ps(&line[base]), scale4), noise)};
+            /* As with fast_roundf, values too large for sub-integral precision,
+             * and NaN, are left as they are.
+             */
+            const __m128 doround{_mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), val),
+                _mm_set1_ps(8388608.0f))};
+            const __m128 rounded{_mm_cvtepi32_ps(_mm_cvtps_epi32(val))};
+            val = _mm_or_ps(_mm_and_ps(doround, rounded), _mm_andnot_ps(doround, val));
+            _mm_store_ps(&line[base], _mm_mul_ps(val, invscale4));
+            counter = _mm_add_epi32(counter, _mm_set1_epi32(8));
+        }
+#endif
+        for(;base < SamplesToDo;++base)
+        {
+            const uint idx{seed + static_cast<uint>(base)*2u};
+            const auto rng0 = static_cast<int>(dither_rng(idx) >> 8);
+            const auto rng1 = static_cast<int>(dither_rng(idx+1u) >> 8);
+            float val{line[base] * quant_scale};
+            val += static_cast<float>(rng0 - rng1) * invRNGRange;
+            line[base] = fast_roundf(val) * invscale;
+        }
+        seed += static_cast<uint>(SamplesToDo) * 2u;
+    }
     *dither_seed = seed;
 }
 
@@ -2145,6 +2446,112 @@ template<> inline uint16_t SampleConv(float val) noexcept
 template<> inline uint8_t SampleConv(float val) noexcept
 { return static_cast<uint8_t>(SampleConv<int8_t>(val) + 128); }
 
+#ifdef HAVE_SSE_INTRINSICS
+/* Converts four samples to the given type, packed in the low elements of the
+ * returned vector. This gives the same results as SampleConv, including for
+ * NaN: the clamp bounds are the first operands of max/min so NaN passes
+ * through like with std::clamp, converting to INT_MIN, and the 16- and 8-bit
+ * results keep the low bits as the scalar cast does instead of saturating.
+ */
+template<typename T>
+inline __m128i SampleConv4(__m128 val) noexcept;
+
+template<> inline __m128i SampleConv4<float>(__m128 val) noexcept
+{ return _mm_castps_si128(val); }
+template<> inline __m128i SampleConv4<int32_t>(__m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(2147483648.0f));
+    val = _mm_min_ps(_mm_set1_ps(2147483520.0f), _mm_max_ps(_mm_set1_ps(-2147483648.0f), val));
+    return _mm_cvtps_epi32(val);
+}
+template<> inline __m128i SampleConv4<int16_t>(__m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(32768.0f));
+    val = _mm_min_ps(_mm_set1_ps(32767.0f), _mm_max_ps(_mm_set1_ps(-32768.0f), val));
+    const __m128i ival{_mm_srai_epi32(_mm_slli_epi32(_mm_cvtps_epi32(val), 16), 16)};
+    return _mm_packs_epi32(ival, ival);
+}
+template<> inline __m128i SampleConv4<int8_t>(__m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(128.0f));
+    val = _mm_min_ps(_mm_set1_ps(127.0f), _mm_max_ps(_mm_set1_ps(-128.0f), val));
+    const __m128i ival{_mm_srai_epi32(_mm_slli_epi32(_mm_cvtps_epi32(val), 24), 24)};
+    const __m128i sval{_mm_packs_epi32(ival, ival)};
+    return _mm_packs_epi16(sval, sval);
+}
+
+/* Unsigned output flips the sign bit of the signed result. */
+template<> inline __m128i SampleConv4<uint32_t>(__m128 val) noexcept
+{ return _mm_xor_si128(SampleConv4<int32_t>(val), _mm_set1_epi32(INT_MIN)); }
+template<> inline __m128i SampleConv4<uint16_t>(__m128 val) noexcept
+{ return _mm_xor_si128(SampleConv4<int16_t>(val), _mm_set1_epi16(SHRT_MIN)); }
+template<> inline __m128i SampleConv4<uint8_t>(__m128 val) noexcept
+{ return _mm_xor_si128(SampleConv4<int8_t>(val), _mm_set1_epi8(SCHAR_MIN)); }
+
+/* Stores Count elements of the packed samples, starting at element Start. */
+template<typename T, size_t Count, size_t Start=0>
+inline void StoreSamples4(T *dst, const __m128i vals) noexcept
+{
+    alignas(16) std::array<T,16/sizeof(T)> tmp;
+    _mm_store_si128(reinterpret_cast<__m128i*>(tmp.data()), vals);
+    std::copy_n(tmp.cbegin()+Start, Count, dst);
+}
+#endif
+
+/* Interleaves and converts samples from a fixed number of channels. Returns
+ * the number of samples written.
+ */
+template<typename T, size_t N>
+size_t WriteInterleaved(const al::span<const FloatBufferLine> InBuffer, const al::span<T> output,
+    const size_t SamplesToDo, const size_t FrameStep)
+{
+    static_assert(N >= 2 && (N&1) == 0, "Unsupported channel count");
+    ASSUME(FrameStep >= N);
+
+    const auto inbuf = InBuffer.first<N>();
+    size_t base{0};
+#ifdef HAVE_SSE_INTRINSICS
+    /* Process four sample frames at a time. Groups of four channels are
+     * transposed so each vector holds one frame, and a remaining pair of
+     * channels is unpacked so each vector holds two frames.
+     */
+    for(;SamplesToDo-base >= 4;base += 4)
+    {
+        const auto out = output.subspan(base*FrameStep);
+        for(size_t c{0};c+4 <= N;c += 4)
+        {
+            __m128 r0{_mm_load_ps(&inbuf[c+0][base])};
+            __m128 r1{_mm_load_ps(&inbuf[c+1][base])};
+            __m128 r2{_mm_load_ps(&inbuf[c+2][base])};
+            __m128 r3{_mm_load_ps(&inbuf[c+3][base])};
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            StoreSamples4<T,4>(&out[c], SampleConv4<T>(r0));
+            StoreSamples4<T,4>(&out[FrameStep + c], SampleConv4<T>(r1));
+            StoreSamples4<T,4>(&out[FrameStep*2 + c], SampleConv4<T>(r2));
+            StoreSamples4<T,4>(&out[FrameStep*3 + c], SampleConv4<T>(r3));
+        }
+        if constexpr((N&3) != 0)
+        {
+            const __m128 a{_mm_load_ps(&inbuf[N-2][base])};
+            const __m128 b{_mm_load_ps(&inbuf[N-1][base])};
+            const __m128i lo{SampleConv4<T>(_mm_unpacklo_ps(a, b))};
+            const __m128i hi{SampleConv4<T>(_mm_unpackhi_ps(a, b))};
+            StoreSamples4<T,2,0>(&out[N-2], lo);
+            StoreSamples4<T,2,2>(&out[FrameStep + N-2], lo);
+            StoreSamples4<T,2,0>(&out[FrameStep*2 + N-2], hi);
+            StoreSamples4<T,2,2>(&out[FrameStep*3 + N-2], hi);
+        }
+    }
+#endif
+    for(;base < SamplesToDo;++base)
+    {
+        const auto out = output.subspan(base*FrameStep, N);
+        for(size_t c{0};c < N;++c)
+            out[c] = SampleConv<T>(inbuf[c][base]);
+    }
+    return SamplesToDo;
+}
+
 template<typename T>
 void Write(const al::span<const FloatBufferLine> InBuffer, void *OutBuffer, const size_t Offset,
     const size_t SamplesToDo, const size_t FrameStep)
@@ -2154,21 +2561,37 @@ void Write(const al::span<const FloatBufferLine> InBuffer, void *OutBuffer, cons
 
     const auto output = al::span{static_cast<T*>(OutBuffer), (Offset+SamplesToDo)*FrameStep}
         .subspan(Offset*FrameStep);
-    size_t c{0};
-    for(const FloatBufferLine &inbuf : InBuffer)
+
+    /* Common channel counts have specialized interleavers, otherwise each
+     * channel is converted and written separately.
+     */
+    size_t done{0};
+    switch(InBuffer.size())
+    {
+    case 2: done = WriteInterleaved<T,2>(InBuffer, output, SamplesToDo, FrameStep); break;
+    case 4: done = WriteInterleaved<T,4>(InBuffer, output, SamplesToDo, FrameStep); break;
+    case 6: done = WriteInterleaved<T,6>(InBuffer, output, SamplesToDo, FrameStep); break;
+    case 8: done = WriteInterleaved<T,8>(InBuffer, output, SamplesToDo, FrameStep); break;
+    }
+    if(done < SamplesToDo)
     {
-        auto out = output.begin();
-        auto conv_sample = [FrameStep,c,&out](const float s) noexcept
+        size_t c{0};
+        for(const FloatBufferLine &inbuf : InBuffer)
         {
-            out[c] = SampleConv<T>(s);
-            out += ptrdiff_t(FrameStep);
-        };
-        std::for_each_n(inbuf.cbegin(), SamplesToDo, conv_sample);
-        ++c;
+            auto out = output.begin();
+            auto conv_sample = [FrameStep,c,&out](const float s) noexcept
+            {
+                out[c] = SampleConv<T>(s);
+                out += ptrdiff_t(FrameStep);
+            };
+            std::for_each_n(inbuf.cbegin(), SamplesToDo, conv_sample);
+            ++c;
+        }
     }
-    if(const size_t extra{FrameStep - c})
+    if(const size_t extra{FrameStep - InBuffer.size()})
     {
         const auto silence = SampleConv<T>(0.0f);
+        const size_t c{InBuffer.size()};
         for(size_t i{0};i < SamplesToDo;++i)
             std::fill_n(&output[i*FrameStep + c], extra, silence);
     }
@@ -2183,8 +2606,14 @@ void Write(const al::span<const FloatBufferLine> InBuffer, al::span<void*> OutBu
     auto srcbuf = InBuffer.cbegin();
     for(auto *dstbuf : OutBuffers)
     {
-        const auto src = al::span{*srcbuf}.first(SamplesToDo);
         const auto dst = al::span{static_cast<T*>(dstbuf), Offset+SamplesToDo}.subspan(Offset);
+        if(srcbuf == InBuffer.cend()) UNLIKELY
+        {
+            /* Any extra output channels get silence. */
+            std::fill(dst.begin(), dst.end(), SampleConv<T>(0.0f));
+            continue;
+        }
+        const auto src = al::span{*srcbuf}.first(SamplesToDo);
         std::transform(src.cbegin(), src.end(), dst.begin(), SampleConv<T>);
         ++srcbuf;
     }
@@ -2192,10 +2621,14 @@ void Write(const al::span<const FloatBufferLine> InBuffer, al::span<void*> OutBu
 
 } // namespace
 
-uint DeviceBase::renderSamples(const uint numSamples)
+template<bool Profiled>
+uint DeviceBase::renderSamples(const uint numSamples, const bool newBlock)
 {
     const uint samplesToDo{std::min(numSamples, uint{BufferLineSize})};
 
+    [[maybe_unused]] MixerProfile *profile{Profiled ? mProfile.get() : nullptr};
+    if constexpr(Profiled) profile->beginPass();
+
     /* Clear main mixing buffers. */
     for(FloatBufferLine &buffer : MixBuffer)
         buffer.fill(0.0f);
@@ -2204,7 +2637,7 @@ uint DeviceBase::renderSamples(const uint numSamples)
         const auto mixLock = getWriteMixLock();
 
         /* Process and mix each context's sources and effects. */
-        ProcessContexts(this, samplesToDo);
+        ProcessContexts<Profiled>(this, samplesToDo, newBlock);
 
         /* Every second's worth of samples is converted and added to clock base
          * so that large sample counts don't overflow during conversion. This
@@ -2220,32 +2653,68 @@ uint DeviceBase::renderSamples(const uint numSamples)
     /* Apply any needed post-process for finalizing the Dry mix to the RealOut
      * (Ambisonic decode, UHJ encode, etc).
      */
+    if constexpr(Profiled) profile->mark();
     postProcess(samplesToDo);
+    if constexpr(Profiled) profile->lap(MixStage::PostProcess);
 
     /* Apply compression, limiting sample amplitude if needed or desired. */
-    if(Limiter) Limiter->process(samplesToDo, RealOut.Buffer);
+    if(Limiter)
+    {
+        Limiter->process(samplesToDo, RealOut.Buffer);
+        if constexpr(Profiled) profile->lap(MixStage::Limiter);
+    }
 
     /* Apply delays and attenuation for mismatched speaker distances. */
     if(ChannelDelays)
+    {
         ApplyDistanceComp(RealOut.Buffer, samplesToDo, ChannelDelays->mChannels);
+        if constexpr(Profiled) profile->lap(MixStage::DistanceComp);
+    }
 
     /* Apply dithering. The compressor should have left enough headroom for the
      * dither noise to not saturate.
      */
     if(DitherDepth > 0.0f)
+    {
         ApplyDither(RealOut.Buffer, &DitherSeed, DitherDepth, samplesToDo);
+        if constexpr(Profiled) profile->lap(MixStage::Dither);
+    }
 
     return samplesToDo;
 }
 
-void DeviceBase::renderSamples(const al::span<void*> outBuffers, const uint numSamples)
+template<bool Profiled, typename F>
+void DeviceBase::renderLoop(const uint numSamples, F&& writer)
 {
-    FPUCtl mixer_mode{};
+    /* Properties are updated at the start of each mixing block, which is
+     * mixed in passes of up to BufferLineSize samples.
+     */
     uint total{0};
+    uint blockLeft{0};
     while(const uint todo{numSamples - total})
     {
-        const uint samplesToDo{renderSamples(todo)};
+        const bool newBlock{blockLeft == 0};
+        if(newBlock)
+            blockLeft = std::min(todo, mMixBlockSize);
+        const uint samplesToDo{renderSamples<Profiled>(blockLeft, newBlock)};
+        blockLeft -= samplesToDo;
+
+        writer(total, samplesToDo);
+        if constexpr(Profiled)
+        {
+            mProfile->lap(MixStage::Write);
+            mProfile->endPass();
+        }
+
+        total += samplesToDo;
+    }
+}
 
+void DeviceBase::renderSamples(const al::span<void*> outBuffers, const uint numSamples)
+{
+    FPUCtl mixer_mode{};
+    auto writer = [this,outBuffers](const uint total, const uint samplesToDo)
+    {
         switch(FmtType)
         {
 #define HANDLE_WRITE(T) case T:                                               \
@@ -2259,19 +2728,27 @@ void DeviceBase::renderSamples(const al::span<void*> outBuffers, const uint numS
         HANDLE_WRITE(DevFmtFloat)
         }
 #undef HANDLE_WRITE
+    };
 
-        total += samplesToDo;
-    }
+    const auto starttime = std::chrono::steady_clock::now();
+
+    /* Profiling is checked once here, so it doesn't cost anything more when
+     * disabled.
+     */
+    if(mProfile) UNLIKELY
+        renderLoop<true>(numSamples, writer);
+    else
+        renderLoop<false>(numSamples, writer);
+
+    if(Type != DeviceType::Loopback)
+        updateMixerLoad(std::chrono::steady_clock::now() - starttime, numSamples);
 }
 
 void DeviceBase::renderSamples(void *outBuffer, const uint numSamples, const size_t frameStep)
 {
     FPUCtl mixer_mode{};
-    uint total{0};
-    while(const uint todo{numSamples - total})
+    auto writer = [this,outBuffer,frameStep](const uint total, const uint samplesToDo)
     {
-        const uint samplesToDo{renderSamples(todo)};
-
         if(outBuffer) LIKELY
         {
             /* Finally, interleave and convert samples, writing to the device's
@@ -2291,9 +2768,75 @@ void DeviceBase::renderSamples(void *outBuffer, const uint numSamples, const siz
 #undef HANDLE_WRITE
             }
         }
+    };
 
-        total += samplesToDo;
+    const auto starttime = std::chrono::steady_clock::now();
+
+    if(mProfile) UNLIKELY
+        renderLoop<true>(numSamples, writer);
+    else
+        renderLoop<false>(numSamples, writer);
+
+    if(Type != DeviceType::Loopback)
+        updateMixerLoad(std::chrono::steady_clock::now() - starttime, numSamples);
+}
+
+void DeviceBase::updateMixerLoad(const nanoseconds renderTime, const uint numSamples)
+{
+    /* Loads at or above this are reported even without any glitches, to give
+     * a chance to reduce the work before it's too late.
+     */
+    static constexpr float LoadWarnLevel{0.8f};
+
+    const nanoseconds budget{nanoseconds{seconds{numSamples}} / Frequency};
+    if(renderTime > budget) UNLIKELY
+    {
+        mDeadlineMisses.store(mDeadlineMisses.load(std::memory_order_relaxed)+1,
+            std::memory_order_relaxed);
+        ++mLoadState.mDeadlineMisses;
+    }
+    const float load{static_cast<float>(renderTime.count()) /
+        static_cast<float>(std::max(budget.count(), nanoseconds::rep{1}))};
+    mLoadState.mPeakLoad = std::max(mLoadState.mPeakLoad, load);
+
+    /* Report no more than twice a second. */
+    mLoadState.mSamples += numSamples;
+    if(mLoadState.mSamples < Frequency/2)
+        return;
+
+    const auto underruns = mUnderruns.load(std::memory_order_relaxed);
+    const auto newUnderruns = static_cast<uint>(std::min<uint64_t>(
+        underruns - mLoadState.mLastUnderruns, std::numeric_limits<uint>::max()));
+    if(mLoadState.mDeadlineMisses > 0 || newUnderruns > 0
+        || mLoadState.mPeakLoad >= LoadWarnLevel)
+    {
+        const auto peak = static_cast<uint>(std::min(mLoadState.mPeakLoad*100.0f, 100000.0f));
+
+        /* Hold the mix lock so the context list stays valid. */
+        const auto mixLock = getWriteMixLock();
+        for(ContextBase *ctx : *mContexts.load(std::memory_order_acquire))
+        {
+            const auto enabledevts = ctx->mEnabledEvts.load(std::memory_order_acquire);
+            if(!enabledevts.test(al::to_underlying(AsyncEnableBits::MixerLoad)))
+                continue;
+
+            RingBuffer *ring{ctx->mAsyncEvents.get()};
+            auto evt_vec = ring->getWriteVector();
+            if(evt_vec.first.len < 1) continue;
+
+            auto &evt = InitAsyncEvent<AsyncMixerLoadEvent>(evt_vec.first.buf);
+            evt.mPeakLoad = peak;
+            evt.mDeadlineMisses = mLoadState.mDeadlineMisses;
+            evt.mUnderruns = newUnderruns;
+            ring->writeAdvance(1);
+            ctx->signalEvents();
+        }
     }
+
+    mLoadState.mSamples = 0;
+    mLoadState.mPeakLoad = 0.0f;
+    mLoadState.mDeadlineMisses = 0;
+    mLoadState.mLastUnderruns = underruns;
 }
 
 void DeviceBase::handleDisconnect(const char *msg, ...)
@@ -2331,7 +2874,7 @@ void DeviceBase::handleDisconnect(const char *msg, ...)
             {
                 al::construct_at(reinterpret_cast<AsyncEvent*>(evt_data.buf), evt);
                 ring->writeAdvance(1);
-                ctx->mEventSem.post();
+                ctx->signalEvents();
             }
 
             if(!ctx->mStopVoicesOnDisconnect.load())
@@ -2341,12 +2884,13 @@ void DeviceBase::handleDisconnect(const char *msg, ...)
             }
 
             auto voicelist = ctx->getVoicesSpanAcquired();
-            auto stop_voice = [](Voice *voice) -> void
+            auto stop_voice = [ctx](Voice *voice) -> void
             {
                 voice->mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
                 voice->mLoopBuffer.store(nullptr, std::memory_order_relaxed);
                 voice->mSourceID.store(0u, std::memory_order_relaxed);
                 voice->mPlayState.store(Voice::Stopped, std::memory_order_release);
+                ctx->addFreeVoice(voice);
             };
             std::for_each(voicelist.begin(), voicelist.end(), stop_voice);
         }
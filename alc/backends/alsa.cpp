@@ -27,6 +27,7 @@
 #include <cassert>
 #include <cerrno>
 #include <chrono>
+#include <cinttypes>
 #include <cstring>
 #include <exception>
 #include <functional>
@@ -103,6 +104,8 @@ using namespace std::string_view_literals;
     MAGIC(snd_pcm_sw_params_malloc);                                          \
     MAGIC(snd_pcm_sw_params_set_avail_min);                                   \
     MAGIC(snd_pcm_sw_params_set_stop_threshold);                              \
+    MAGIC(snd_pcm_sw_params_set_tstamp_mode);                                 \
+    MAGIC(snd_pcm_sw_params_set_tstamp_type);                                 \
     MAGIC(snd_pcm_prepare);                                                   \
     MAGIC(snd_pcm_start);                                                     \
     MAGIC(snd_pcm_resume);                                                    \
@@ -110,7 +113,9 @@ using namespace std::string_view_literals;
     MAGIC(snd_pcm_wait);                                                      \
     MAGIC(snd_pcm_delay);                                                     \
     MAGIC(snd_pcm_state);                                                     \
+    MAGIC(snd_pcm_avail);                                                     \
     MAGIC(snd_pcm_avail_update);                                              \
+    MAGIC(snd_pcm_htimestamp);                                                \
     MAGIC(snd_pcm_mmap_begin);                                                \
     MAGIC(snd_pcm_mmap_commit);                                               \
     MAGIC(snd_pcm_readi);                                                     \
@@ -181,6 +186,8 @@ ALSA_FUNCS(MAKE_FUNC);
 #define snd_pcm_sw_params_current psnd_pcm_sw_params_current
 #define snd_pcm_sw_params_set_avail_min psnd_pcm_sw_params_set_avail_min
 #define snd_pcm_sw_params_set_stop_threshold psnd_pcm_sw_params_set_stop_threshold
+#define snd_pcm_sw_params_set_tstamp_mode psnd_pcm_sw_params_set_tstamp_mode
+#define snd_pcm_sw_params_set_tstamp_type psnd_pcm_sw_params_set_tstamp_type
 #define snd_pcm_sw_params psnd_pcm_sw_params
 #define snd_pcm_sw_params_free psnd_pcm_sw_params_free
 #define snd_pcm_prepare psnd_pcm_prepare
@@ -190,7 +197,9 @@ ALSA_FUNCS(MAKE_FUNC);
 #define snd_pcm_wait psnd_pcm_wait
 #define snd_pcm_delay psnd_pcm_delay
 #define snd_pcm_state psnd_pcm_state
+#define snd_pcm_avail psnd_pcm_avail
 #define snd_pcm_avail_update psnd_pcm_avail_update
+#define snd_pcm_htimestamp psnd_pcm_htimestamp
 #define snd_pcm_mmap_begin psnd_pcm_mmap_begin
 #define snd_pcm_mmap_commit psnd_pcm_mmap_commit
 #define snd_pcm_readi psnd_pcm_readi
@@ -474,6 +483,7 @@ struct AlsaPlayback final : public BackendBase {
     ~AlsaPlayback() override;
 
     int mixerProc();
+    int mixerTimerProc();
     int mixerNoMMapProc();
 
     void open(std::string_view name) override;
@@ -490,6 +500,12 @@ struct AlsaPlayback final : public BackendBase {
     uint mFrameStep{};
     std::vector<std::byte> mBuffer;
 
+    /* Set when the timer-driven mixer should be used with mmap access, and
+     * whether ALSA's timestamps are on the same clock as std::steady_clock.
+     */
+    bool mTimerMode{false};
+    bool mMonotonicTstamp{false};
+
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
 };
@@ -518,6 +534,8 @@ int AlsaPlayback::mixerProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            mDevice->noteUnderrun();
 
         snd_pcm_sframes_t avails{snd_pcm_avail_update(mPcmHandle)};
         if(avails < 0)
@@ -586,6 +604,205 @@ int AlsaPlayback::mixerProc()
     return 0;
 }
 
+/* Instead of waiting for the device to signal a whole period is available,
+ * this keeps only about a period's worth of samples queued in the buffer,
+ * topping it up in smaller chunks as the device consumes it. The mixer sleeps
+ * until the queued amount is expected to drop below the target, as calculated
+ * from the buffer's hardware timestamp, so latency is determined by the target
+ * level rather than the buffer size.
+ */
+int AlsaPlayback::mixerTimerProc()
+{
+    using std::chrono::steady_clock;
+    using std::chrono::nanoseconds;
+    using std::chrono::microseconds;
+
+    SetRTPriority();
+    althrd_setname(GetMixerThreadName());
+
+    const snd_pcm_uframes_t buffer_size{mDevice->BufferSize};
+    const snd_pcm_uframes_t update_size{std::min<snd_pcm_uframes_t>(mDevice->UpdateSize,
+        buffer_size/2)};
+    const snd_pcm_uframes_t chunk_size{std::max<snd_pcm_uframes_t>(update_size/4, 16)};
+    const snd_pcm_uframes_t target_size{update_size};
+    const uint frequency{mDevice->Frequency};
+
+    auto frames_to_ns = [frequency](snd_pcm_uframes_t frames) noexcept -> nanoseconds
+    { return nanoseconds{static_cast<int64_t>(frames * 1'000'000'000_u64 / frequency)}; };
+
+    nanoseconds jitter_total{};
+    nanoseconds jitter_max{};
+    uint64_t wakeups{0};
+
+    /* Failures the device may recover from are retried after a chunk's worth
+     * of time, rather than immediately. If they persist for a second, the
+     * device is treated as lost.
+     */
+    const nanoseconds retry_delay{frames_to_ns(chunk_size)};
+    nanoseconds retry_total{};
+    auto retry_later = [this,retry_delay,&retry_total](const char *what) -> bool
+    {
+        retry_total += retry_delay;
+        if(retry_total >= std::chrono::seconds{1})
+        {
+            mDevice->handleDisconnect("Failed to recover: %s", what);
+            return false;
+        }
+        std::this_thread::sleep_for(retry_delay);
+        return true;
+    };
+
+    while(!mKillNow.load(std::memory_order_acquire))
+    {
+        int state{verify_state(mPcmHandle)};
+        if(state < 0)
+        {
+            ERR("Invalid state detected: %s\n", snd_strerror(state));
+            mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
+            break;
+        }
+        if(state == SND_PCM_STATE_XRUN)
+            mDevice->noteUnderrun();
+
+        /* Make sure the hardware pointer is up to date, then get the available
+         * space along with the time it was measured.
+         */
+        if(snd_pcm_sframes_t res{snd_pcm_avail(mPcmHandle)}; res < 0)
+        {
+            ERR("available failed: %s\n", snd_strerror(static_cast<int>(res)));
+            if(!retry_later(snd_strerror(static_cast<int>(res))))
+                break;
+            continue;
+        }
+        snd_pcm_uframes_t avail{};
+        snd_htimestamp_t tstamp{};
+        if(int err{snd_pcm_htimestamp(mPcmHandle, &avail, &tstamp)}; err < 0)
+        {
+            ERR("htimestamp failed: %s\n", snd_strerror(err));
+            if(!retry_later(snd_strerror(err)))
+                break;
+            continue;
+        }
+        const auto now = steady_clock::now();
+
+        if(avail > buffer_size)
+        {
+            WARN("available samples exceeds the buffer size\n");
+            snd_pcm_reset(mPcmHandle);
+            if(!retry_later("available samples exceeds the buffer size"))
+                break;
+            continue;
+        }
+
+        /* Account for the samples played since the timestamp was taken.
+         * Timestamps from a stopped device, or ones not on the monotonic clock,
+         * can't be used for this.
+         */
+        snd_pcm_uframes_t queued{buffer_size - avail};
+        if(state == SND_PCM_STATE_RUNNING && mMonotonicTstamp
+            && (tstamp.tv_sec != 0 || tstamp.tv_nsec != 0))
+        {
+            const auto stamptime = steady_clock::time_point{std::chrono::duration_cast<
+                steady_clock::duration>(std::chrono::seconds{tstamp.tv_sec}
+                + nanoseconds{tstamp.tv_nsec})};
+            if(stamptime < now)
+            {
+                const auto played = static_cast<snd_pcm_uframes_t>(
+                    static_cast<uint64_t>(nanoseconds{now-stamptime}.count()) * frequency
+                    / 1'000'000'000);
+                queued -= std::min(queued, played);
+            }
+        }
+
+        /* Top up the buffer to the target level, in whole chunks. */
+        snd_pcm_uframes_t todo{0};
+        if(queued < target_size)
+        {
+            todo = (target_size - queued + chunk_size-1) / chunk_size * chunk_size;
+            todo = std::min(todo, avail);
+        }
+
+        if(todo > 0)
+        {
+            std::lock_guard<std::mutex> dlock{mMutex};
+            snd_pcm_uframes_t remaining{todo};
+            while(remaining > 0)
+            {
+                snd_pcm_uframes_t frames{remaining};
+
+                const snd_pcm_channel_area_t *areas{};
+                snd_pcm_uframes_t offset{};
+                int err{snd_pcm_mmap_begin(mPcmHandle, &areas, &offset, &frames)};
+                if(err < 0)
+                {
+                    ERR("mmap begin error: %s\n", snd_strerror(err));
+                    break;
+                }
+
+                /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+                char *WritePtr{static_cast<char*>(areas->addr) + (offset * areas->step / 8)};
+                mDevice->renderSamples(WritePtr, static_cast<uint>(frames), mFrameStep);
+
+                snd_pcm_sframes_t commitres{snd_pcm_mmap_commit(mPcmHandle, offset, frames)};
+                if(commitres < 0 || static_cast<snd_pcm_uframes_t>(commitres) != frames)
+                {
+                    ERR("mmap commit error: %s\n",
+                        snd_strerror(commitres >= 0 ? -EPIPE : static_cast<int>(commitres)));
+                    break;
+                }
+
+                remaining -= frames;
+            }
+            queued += todo - remaining;
+        }
+
+        if(state != SND_PCM_STATE_RUNNING)
+        {
+            /* Not reaching the target level here means writing failed. */
+            if(queued < target_size)
+            {
+                if(!retry_later("failed to fill the buffer"))
+                    break;
+                continue;
+            }
+            if(int err{snd_pcm_start(mPcmHandle)}; err < 0)
+            {
+                ERR("start failed: %s\n", snd_strerror(err));
+                if(!retry_later(snd_strerror(err)))
+                    break;
+                continue;
+            }
+        }
+        retry_total = nanoseconds{};
+
+        /* Sleep until the queued amount is expected to fall a chunk below the
+         * target, and measure how late the wake-up was. Waking more than a
+         * chunk late leaves the queue below where it should have been topped
+         * up, which is reported as a missed deadline.
+         */
+        const snd_pcm_uframes_t low_mark{target_size - std::min(target_size, chunk_size)};
+        const auto deadline = now + frames_to_ns((queued > low_mark) ? queued-low_mark : 0);
+        std::this_thread::sleep_until(deadline);
+
+        const auto late = steady_clock::now() - deadline;
+        jitter_total += late;
+        jitter_max = std::max<nanoseconds>(jitter_max, late);
+        ++wakeups;
+        if(late > frames_to_ns(chunk_size))
+            mDevice->noteDeadlineMiss();
+    }
+
+    if(wakeups > 0)
+    {
+        const auto average = std::chrono::duration_cast<microseconds>(jitter_total / static_cast<int64_t>(wakeups));
+        TRACE("Timer wake-up jitter over %" PRIu64 " wake-ups: %" PRId64 "us avg, %" PRId64 "us max\n",
+            wakeups, int64_t{average.count()},
+            int64_t{std::chrono::duration_cast<microseconds>(jitter_max).count()});
+    }
+
+    return 0;
+}
+
 int AlsaPlayback::mixerNoMMapProc()
 {
     SetRTPriority();
@@ -602,6 +819,8 @@ int AlsaPlayback::mixerNoMMapProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            mDevice->noteUnderrun();
 
         snd_pcm_sframes_t avail{snd_pcm_avail_update(mPcmHandle)};
         if(avail < 0)
@@ -650,6 +869,8 @@ int AlsaPlayback::mixerNoMMapProc()
 #endif
             case -EPIPE:
             case -EINTR:
+                if(ret == -EPIPE)
+                    mDevice->noteUnderrun();
                 ret = snd_pcm_recover(mPcmHandle, static_cast<int>(ret), 1);
                 if(ret < 0)
                     avail = 0;
@@ -709,7 +930,7 @@ void AlsaPlayback::open(std::string_view name)
     /* Free alsa's global config tree. Otherwise valgrind reports a ton of leaks. */
     snd_config_update_free_global();
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool AlsaPlayback::reset()
@@ -831,9 +1052,27 @@ bool AlsaPlayback::reset()
     CHECK(snd_pcm_sw_params_current(mPcmHandle, sp.get()));
     CHECK(snd_pcm_sw_params_set_avail_min(mPcmHandle, sp.get(), periodSizeInFrames));
     CHECK(snd_pcm_sw_params_set_stop_threshold(mPcmHandle, sp.get(), bufferSizeInFrames));
+    mTimerMode = access == SND_PCM_ACCESS_MMAP_INTERLEAVED
+        && GetConfigValueBool(mDevice->DeviceName, "alsa"sv, "timer-scheduling"sv, false);
+    mMonotonicTstamp = false;
+    if(mTimerMode)
+    {
+        /* The timer-driven mixer needs timestamps on the monotonic clock to
+         * track the playback position between wake-ups.
+         */
+        if(int err{snd_pcm_sw_params_set_tstamp_mode(mPcmHandle, sp.get(), SND_PCM_TSTAMP_ENABLE)}; err < 0)
+            WARN("Failed to enable timestamps: %s\n", snd_strerror(err));
+        else if(err = snd_pcm_sw_params_set_tstamp_type(mPcmHandle, sp.get(),
+            SND_PCM_TSTAMP_TYPE_MONOTONIC); err < 0)
+            WARN("Failed to set monotonic timestamps: %s\n", snd_strerror(err));
+        else
+            mMonotonicTstamp = true;
+    }
     CHECK(snd_pcm_sw_params(mPcmHandle, sp.get()));
 #undef CHECK
     sp = nullptr;
+    TRACE("Using %s mixing\n", !mTimerMode ? "period-driven" :
+        mMonotonicTstamp ? "timer-driven" : "timer-driven (no timestamps)");
 
     mDevice->BufferSize = static_cast<uint>(bufferSizeInFrames);
     mDevice->UpdateSize = static_cast<uint>(periodSizeInFrames);
@@ -868,7 +1107,7 @@ void AlsaPlayback::start()
     else
     {
         CHECK(snd_pcm_prepare(mPcmHandle));
-        thread_func = &AlsaPlayback::mixerProc;
+        thread_func = mTimerMode ? &AlsaPlayback::mixerTimerProc : &AlsaPlayback::mixerProc;
     }
 #undef CHECK
 
@@ -1038,7 +1277,7 @@ void AlsaCapture::open(std::string_view name)
     if(needring)
         mRing = RingBuffer::Create(mDevice->BufferSize, mDevice->frameSizeFromFmt(), false);
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 
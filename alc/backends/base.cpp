@@ -26,6 +26,13 @@ backend_exception::~backend_exception() = default;
 } // namespace al
 
 
+void BackendBase::applyOpenedProps() const
+{
+    mDevice->DeviceName = mOpenedName;
+    if(mOpenedDirectEar)
+        mDevice->Flags.set(DirectEar, *mOpenedDirectEar);
+}
+
 bool BackendBase::reset()
 { throw al::backend_exception{al::backend_error::DeviceError, "Invalid BackendBase call"}; }
 
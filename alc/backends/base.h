@@ -5,6 +5,7 @@
 #include <cstdarg>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <ratio>
 #include <string>
 #include <string_view>
@@ -36,6 +37,16 @@ struct BackendBase {
 
     DeviceBase *const mDevice;
 
+    /* Properties of the opened device. open() sets these instead of the
+     * device's fields, since a device being reopened is still mixing through
+     * its old backend at that point.
+     */
+    std::string mOpenedName;
+    std::optional<bool> mOpenedDirectEar;
+
+    /** Applies the properties from open() to the device. */
+    void applyOpenedProps() const;
+
     BackendBase() = delete;
     BackendBase(const BackendBase&) = delete;
     BackendBase(BackendBase&&) = delete;
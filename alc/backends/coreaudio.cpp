@@ -435,7 +435,7 @@ void CoreAudioPlayback::open(std::string_view name)
 
 #if CAN_ENUMERATE
     if(!name.empty())
-        mDevice->DeviceName = name;
+        mOpenedName = name;
     else
     {
         UInt32 propSize{sizeof(audioDevice)};
@@ -444,8 +444,8 @@ void CoreAudioPlayback::open(std::string_view name)
             kAudioUnitScope_Global, OutputElement, &audioDevice, &propSize);
 
         std::string devname{GetDeviceName(audioDevice)};
-        if(!devname.empty()) mDevice->DeviceName = std::move(devname);
-        else mDevice->DeviceName = "Unknown Device Name";
+        if(!devname.empty()) mOpenedName = std::move(devname);
+        else mOpenedName = "Unknown Device Name";
     }
 
     if(audioDevice != kAudioDeviceUnknown)
@@ -458,12 +458,12 @@ void CoreAudioPlayback::open(std::string_view name)
         else
         {
             TRACE("Got device type '%s'\n", FourCCPrinter{type}.c_str());
-            mDevice->Flags.set(DirectEar, (type == kIOAudioOutputPortSubTypeHeadphones));
+            mOpenedDirectEar = (type == kIOAudioOutputPortSubTypeHeadphones);
         }
     }
 
 #else
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 #endif
 }
 
@@ -885,7 +885,7 @@ void CoreAudioCapture::open(std::string_view name)
 
 #if CAN_ENUMERATE
     if(!name.empty())
-        mDevice->DeviceName = name;
+        mOpenedName = name;
     else
     {
         UInt32 propSize{sizeof(audioDevice)};
@@ -894,11 +894,11 @@ void CoreAudioCapture::open(std::string_view name)
             kAudioUnitScope_Global, InputElement, &audioDevice, &propSize);
 
         std::string devname{GetDeviceName(audioDevice)};
-        if(!devname.empty()) mDevice->DeviceName = std::move(devname);
-        else mDevice->DeviceName = "Unknown Device Name";
+        if(!devname.empty()) mOpenedName = std::move(devname);
+        else mOpenedName = "Unknown Device Name";
     }
 #else
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 #endif
 }
 
@@ -356,7 +356,7 @@ void DSoundPlayback::open(std::string_view name)
     mPrimaryBuffer = nullptr;
     mDS = std::move(ds);
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool DSoundPlayback::reset()
@@ -691,7 +691,7 @@ void DSoundCapture::open(std::string_view name)
     mBufferBytes = DSCBDescription.dwBufferBytes;
     setDefaultWFXChannelOrder();
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 void DSoundCapture::start()
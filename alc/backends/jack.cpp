@@ -510,7 +510,7 @@ void JackPlayback::open(std::string_view name)
         mPortPattern = iter->mPattern;
     }
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool JackPlayback::reset()
@@ -82,6 +82,11 @@ int NullBackend::mixerProc()
             std::this_thread::sleep_for(restTime);
             continue;
         }
+        /* A real device would have run out of samples if the mixer fell more
+         * than a buffer behind.
+         */
+        if(avail-done > mDevice->BufferSize)
+            mDevice->noteUnderrun();
         while(avail-done >= mDevice->UpdateSize)
         {
             mDevice->renderSamples(nullptr, mDevice->UpdateSize, 0u);
@@ -113,7 +118,7 @@ void NullBackend::open(std::string_view name)
         throw al::backend_exception{al::backend_error::NoDevice, "Device name \"%.*s\" not found",
             al::sizei(name), name.data()};
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool NullBackend::reset()
@@ -588,7 +588,7 @@ void OtherIOPlayback::open(std::string_view name)
         throw al::backend_exception{al::backend_error::DeviceError, "Failed to open \"%.*s\"",
             al::sizei(name), name.data()};
 
-    mDevice->DeviceName = "OpenAL Soft on "+std::string{name};
+    mOpenedName = "OpenAL Soft on "+std::string{name};
 }
 
 auto OtherIOPlayback::openProxy(std::string_view name [[maybe_unused]]) -> HRESULT
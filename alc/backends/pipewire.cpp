@@ -1600,9 +1600,9 @@ void PipeWirePlayback::open(std::string_view name)
 
     mTargetId = targetid;
     if(!devname.empty())
-        mDevice->DeviceName = std::move(devname);
+        mOpenedName = std::move(devname);
     else
-        mDevice->DeviceName = "PipeWire Output"sv;
+        mOpenedName = "PipeWire Output"sv;
 }
 
 bool PipeWirePlayback::reset()
@@ -2066,9 +2066,9 @@ void PipeWireCapture::open(std::string_view name)
 
     mTargetId = targetid;
     if(!devname.empty())
-        mDevice->DeviceName = std::move(devname);
+        mOpenedName = std::move(devname);
     else
-        mDevice->DeviceName = "PipeWire Input"sv;
+        mOpenedName = "PipeWire Input"sv;
 
 
     bool is51rear{false};
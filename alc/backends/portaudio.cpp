@@ -225,7 +225,7 @@ void PortPlayback::open(std::string_view name)
     createStream(deviceid);
     mDeviceIdx = deviceid;
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool PortPlayback::reset()
@@ -401,7 +401,7 @@ void PortCapture::open(std::string_view name)
         throw al::backend_exception{al::backend_error::NoDevice, "Failed to open stream: %s",
             Pa_GetErrorText(err)};
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 
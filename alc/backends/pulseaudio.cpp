@@ -775,7 +775,7 @@ void PulsePlayback::sinkNameCallback(pa_context*, const pa_sink_info *info, int
         mMainloop.signal();
         return;
     }
-    mDevice->DeviceName = info->description;
+    mOpenedName = info->description;
 }
 
 void PulsePlayback::streamMovedCallback(pa_stream *stream) noexcept
@@ -848,7 +848,7 @@ void PulsePlayback::open(std::string_view name)
         plock.waitForOperation(op);
     }
     else
-        mDevice->DeviceName = display_name;
+        mOpenedName = display_name;
 }
 
 bool PulsePlayback::reset()
@@ -1126,7 +1126,7 @@ void PulseCapture::sourceNameCallback(pa_context*, const pa_source_info *info, i
         mMainloop.signal();
         return;
     }
-    mDevice->DeviceName = info->description;
+    mOpenedName = info->description;
 }
 
 void PulseCapture::streamMovedCallback(pa_stream *stream) noexcept
@@ -1160,7 +1160,7 @@ void PulseCapture::open(std::string_view name)
                 "Device name \"%.*s\" not found", al::sizei(name), name.data()};
 
         pulse_name = iter->device_name.c_str();
-        mDevice->DeviceName = iter->name;
+        mOpenedName = iter->name;
     }
 
     MainloopUniqueLock plock{mMainloop};
@@ -1236,7 +1236,7 @@ void PulseCapture::open(std::string_view name)
 
     if(pulse_name) mDeviceName.emplace(pulse_name);
     else mDeviceName.reset();
-    if(mDevice->DeviceName.empty())
+    if(mOpenedName.empty())
     {
         constexpr auto name_callback = [](pa_context *context, const pa_source_info *info, int eol,
             void *pdata) noexcept
@@ -147,7 +147,7 @@ void Sdl2Backend::open(std::string_view name)
 
     mFrameSize = BytesFromDevFmt(devtype) * have.channels;
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool Sdl2Backend::reset()
@@ -1436,9 +1436,9 @@ HRESULT WasapiPlayback::openProxy(std::string_view name)
         return hr;
     }
     if(!devname.empty())
-        mDevice->DeviceName = std::string{GetDevicePrefix()}+std::move(devname);
+        mOpenedName = std::string{GetDevicePrefix()}+std::move(devname);
     else
-        mDevice->DeviceName = std::string{GetDevicePrefix()}+GetDeviceNameAndGuid(mMMDev).first;
+        mOpenedName = std::string{GetDevicePrefix()}+GetDeviceNameAndGuid(mMMDev).first;
 
     return S_OK;
 }
@@ -2342,9 +2342,9 @@ HRESULT WasapiCapture::openProxy(std::string_view name)
     }
     mClient = nullptr;
     if(!devname.empty())
-        mDevice->DeviceName = std::string{GetDevicePrefix()}+std::move(devname);
+        mOpenedName = std::string{GetDevicePrefix()}+std::move(devname);
     else
-        mDevice->DeviceName = std::string{GetDevicePrefix()}+GetDeviceNameAndGuid(mMMDev).first;
+        mOpenedName = std::string{GetDevicePrefix()}+GetDeviceNameAndGuid(mMMDev).first;
 
     return S_OK;
 }
@@ -144,6 +144,11 @@ int WaveBackend::mixerProc()
             std::this_thread::sleep_for(restTime);
             continue;
         }
+        /* A real device would have run out of samples if the mixer fell more
+         * than a buffer behind.
+         */
+        if(avail-done > mDevice->BufferSize)
+            mDevice->noteUnderrun();
         while(avail-done >= mDevice->UpdateSize)
         {
             mDevice->renderSamples(mBuffer.data(), mDevice->UpdateSize, frameStep);
@@ -222,7 +227,7 @@ void WaveBackend::open(std::string_view name)
         throw al::backend_exception{al::backend_error::DeviceError, "Could not open file '%s': %s",
             fname->c_str(), std::generic_category().message(errno).c_str()};
 
-    mDevice->DeviceName = name;
+    mOpenedName = name;
 }
 
 bool WaveBackend::reset()
@@ -256,7 +256,7 @@ void WinMMPlayback::open(std::string_view name)
 
     mFormat = format;
 
-    mDevice->DeviceName = PlaybackDevices[DeviceID];
+    mOpenedName = PlaybackDevices[DeviceID];
 }
 
 bool WinMMPlayback::reset()
@@ -521,7 +521,7 @@ void WinMMCapture::open(std::string_view name)
         mWaveBuffer[i].dwBufferLength = mWaveBuffer[i-1].dwBufferLength;
     }
 
-    mDevice->DeviceName = CaptureDevices[DeviceID];
+    mOpenedName = CaptureDevices[DeviceID];
 }
 
 void WinMMCapture::start()
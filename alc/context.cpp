@@ -76,21 +76,28 @@ std::vector<std::string_view> getContextExtensions() noexcept
         "AL_SOFT_callback_buffer"sv,
         "AL_SOFTX_convolution_effect"sv,
         "AL_SOFT_deferred_updates"sv,
+        "AL_SOFTX_device_bus"sv,
         "AL_SOFT_direct_channels"sv,
         "AL_SOFT_direct_channels_remix"sv,
         "AL_SOFT_effect_target"sv,
+        "AL_SOFTX_event_batch"sv,
+        "AL_SOFTX_event_poll"sv,
         "AL_SOFT_events"sv,
         "AL_SOFT_gain_clamp_ex"sv,
         "AL_SOFTX_hold_on_disconnect"sv,
         "AL_SOFT_loop_points"sv,
         "AL_SOFTX_map_buffer"sv,
+        "AL_SOFTX_mixer_load_events"sv,
         "AL_SOFT_MSADPCM"sv,
+        "AL_SOFTX_pitch_shifter_quality"sv,
         "AL_SOFT_source_latency"sv,
         "AL_SOFT_source_length"sv,
         "AL_SOFTX_source_panning"sv,
         "AL_SOFT_source_resampler"sv,
+        "AL_SOFTX_source_schedule"sv,
         "AL_SOFT_source_spatialize"sv,
         "AL_SOFT_source_start_delay"sv,
+        "AL_SOFTX_source_states"sv,
         "AL_SOFT_UHJ"sv,
         "AL_SOFT_UHJ_ex"sv,
     };
@@ -169,13 +176,16 @@ void ALCcontext::init()
     }
     mActiveAuxSlots.store(std::move(auxslots), std::memory_order_relaxed);
 
-    allocVoiceChanges();
+    do {
+        allocVoiceChanges();
+    } while(numVoiceChanges() < mVoiceChangeReserve);
     {
         VoiceChange *cur{mVoiceChangeTail};
         while(VoiceChange *next{cur->mNext.load(std::memory_order_relaxed)})
             cur = next;
         mCurrentVoiceChange.store(cur, std::memory_order_relaxed);
     }
+    reserveProps();
 
     mExtensions = getContextExtensions();
 
@@ -229,7 +239,6 @@ void ALCcontext::init()
 
 
     allocVoices(256);
-    mActiveVoiceCount.store(64, std::memory_order_relaxed);
 }
 
 void ALCcontext::deinit()
@@ -252,6 +261,11 @@ void ALCcontext::deinit()
         dec_ref();
     }
 
+    /* Give up the device buses before the context stops mixing, so other
+     * contexts' voices are done with them before the slots go away.
+     */
+    LeaveAllDeviceBuses(this);
+
     bool stopPlayback{};
     /* First make sure this context exists in the device's list. */
     auto *oldarray = mDevice->mContexts.load(std::memory_order_acquire);
@@ -97,6 +97,8 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     std::mutex mEventCbLock;
     ALEVENTPROCSOFT mEventCb{};
     void *mEventParam{nullptr};
+    ALEVENTBATCHPROCSOFT mEventBatchCb{};
+    void *mEventBatchParam{nullptr};
 
     std::mutex mDebugCbLock;
     ALDEBUGPROCEXT mDebugCb{};
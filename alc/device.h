@@ -1,7 +1,9 @@
 #ifndef ALC_DEVICE_H
 #define ALC_DEVICE_H
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -50,6 +52,32 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice>, DeviceBase {
     std::vector<std::string> mHrtfList;
     ALCenum mHrtfStatus{ALC_FALSE};
 
+    /* The output parameters the renderer was last set up for. A reset that
+     * ends up with the same ones keeps the existing renderer.
+     */
+    struct RenderParams {
+        uint Frequency{};
+        DevFmtChannels FmtChans{};
+        uint AmbiOrder{};
+        DevAmbiLayout AmbiLayout{};
+        DevAmbiScaling AmbiScale{};
+        std::array<std::uint8_t,MaxChannels> ChannelIndex{};
+        int HrtfId{};
+        std::optional<StereoEncoding> StereoMode;
+        bool DirectEar{};
+
+        bool operator==(const RenderParams &rhs) const noexcept
+        {
+            return Frequency == rhs.Frequency && FmtChans == rhs.FmtChans
+                && AmbiOrder == rhs.AmbiOrder && AmbiLayout == rhs.AmbiLayout
+                && AmbiScale == rhs.AmbiScale && ChannelIndex == rhs.ChannelIndex
+                && HrtfId == rhs.HrtfId && StereoMode == rhs.StereoMode
+                && DirectEar == rhs.DirectEar;
+        }
+        bool operator!=(const RenderParams &rhs) const noexcept { return !(*this == rhs); }
+    };
+    std::optional<RenderParams> mRenderParams;
+
     enum class OutputMode1 : ALCenum {
         Any = ALC_ANY_SOFT,
         Mono = ALC_MONO_SOFT,
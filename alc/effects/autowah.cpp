@@ -48,6 +48,28 @@ constexpr float MinFreq{20.0f};
 constexpr float MaxFreq{2500.0f};
 constexpr float QFactor{5.0f};
 
+/* The cosine and alpha filter components for normalized frequencies from 0 to
+ * 0.5, which the envelope follower interpolates between. With this many
+ * steps, the interpolation error is less than 3e-7.
+ */
+constexpr size_t CoeffTableSteps{2048};
+
+struct FilterCoeffTable {
+    std::array<float,CoeffTableSteps+1> mCosW0{};
+    std::array<float,CoeffTableSteps+1> mAlpha{};
+
+    FilterCoeffTable() noexcept
+    {
+        for(size_t i{0};i <= CoeffTableSteps;++i)
+        {
+            const double w0{static_cast<double>(i) / double{CoeffTableSteps} * al::numbers::pi};
+            mCosW0[i] = static_cast<float>(std::cos(w0));
+            mAlpha[i] = static_cast<float>(std::sin(w0) / (2.0*QFactor));
+        }
+    }
+};
+const FilterCoeffTable gCoeffTable{};
+
 struct AutowahState final : public EffectState {
     /* Effect parameters */
     float mAttackRate{};
@@ -58,10 +80,14 @@ struct AutowahState final : public EffectState {
     float mBandwidthNorm{};
     float mEnvDelay{};
 
-    /* Filter components derived from the envelope. */
+    /* Normalized filter coefficients derived from the envelope, shared by
+     * all channels. The a1 coefficient is the same as b1 for a peaking filter.
+     */
     struct FilterParam {
-        float cos_w0{};
-        float alpha{};
+        float b0{1.0f};
+        float b1{};
+        float b2{};
+        float a2{};
     };
     std::array<FilterParam,BufferLineSize> mEnv;
 
@@ -102,11 +128,7 @@ void AutowahState::deviceUpdate(const DeviceBase*, const BufferStorage*)
     mBandwidthNorm = 0.05f;
     mEnvDelay      = 0.0f;
 
-    for(auto &e : mEnv)
-    {
-        e.cos_w0 = 0.0f;
-        e.alpha = 0.0f;
-    }
+    std::fill(mEnv.begin(), mEnv.end(), FilterParam{});
 
     for(auto &chan : mChans)
     {
@@ -133,6 +155,10 @@ void AutowahState::update(const ContextBase *context, const EffectSlot *slot,
     mPeakGain      = 1.0f - std::log10(props.PeakGain / GainScale);
     mFreqMinNorm   = MinFreq / frequency;
     mBandwidthNorm = (MaxFreq-MinFreq) / frequency;
+    /* The resonant filter rings longest when the envelope leaves it near
+     * MinFreq, which takes under a second to die out.
+     */
+    mTailLength = device->Frequency;
 
     mOutTarget = target.Main->Buffer;
     auto set_channel = [this](size_t idx, uint outchan, float outgain)
@@ -163,11 +189,22 @@ void AutowahState::process(const size_t samplesToDo,
         const float a{(sample > env_delay) ? attack_rate : release_rate};
         env_delay = lerpf(sample, env_delay, a);
 
-        /* Calculate the cos and alpha components for this sample's filter. */
-        const float w0{std::min(bandwidth*env_delay + freq_min, 0.46f) *
-            (al::numbers::pi_v<float>*2.0f)};
-        mEnv[i].cos_w0 = std::cos(w0);
-        mEnv[i].alpha = std::sin(w0)/(2.0f * QFactor);
+        /* Look up the cos and alpha components for this sample's filter, and
+         * calculate its coefficients (see BiquadFilter::setParams for the
+         * peaking filter).
+         */
+        const float fpos{std::min(bandwidth*env_delay + freq_min, 0.46f) *
+            float{CoeffTableSteps*2}};
+        const size_t idx{float2uint(fpos)};
+        const float frac{fpos - static_cast<float>(idx)};
+        const float cos_w0{lerpf(gCoeffTable.mCosW0[idx], gCoeffTable.mCosW0[idx+1], frac)};
+        const float alpha{lerpf(gCoeffTable.mAlpha[idx], gCoeffTable.mAlpha[idx+1], frac)};
+
+        const float a0_rcp{1.0f / (1.0f + alpha/res_gain)};
+        mEnv[i].b0 = (1.0f + alpha*res_gain) * a0_rcp;
+        mEnv[i].b1 = -2.0f * cos_w0 * a0_rcp;
+        mEnv[i].b2 = (1.0f - alpha*res_gain) * a0_rcp;
+        mEnv[i].a2 = (1.0f - alpha/res_gain) * a0_rcp;
     }
     mEnvDelay = env_delay;
 
@@ -181,33 +218,22 @@ void AutowahState::process(const size_t samplesToDo,
             continue;
         }
 
-        /* This effectively inlines BiquadFilter_setParams for a peaking
-         * filter and BiquadFilter_processC. The alpha and cosine components
-         * for the filter coefficients were previously calculated with the
-         * envelope. Because the filter changes for each sample, the
-         * coefficients are transient and don't need to be held.
+        /* This effectively inlines BiquadFilter::process, with the filter
+         * coefficients previously calculated with the envelope. Because the
+         * filter changes for each sample, the coefficients are transient and
+         * don't need to be held.
          */
         float z1{chandata->mFilter.z1};
         float z2{chandata->mFilter.z2};
 
         for(size_t i{0u};i < samplesToDo;i++)
         {
-            const float alpha{mEnv[i].alpha};
-            const float cos_w0{mEnv[i].cos_w0};
-
-            const std::array b{
-                1.0f + alpha*res_gain,
-                -2.0f * cos_w0,
-                1.0f - alpha*res_gain};
-            const std::array a{
-                1.0f + alpha/res_gain,
-                -2.0f * cos_w0,
-                1.0f - alpha/res_gain};
+            const FilterParam &coeffs = mEnv[i];
 
             const float input{insamples[i]};
-            const float output{input*(b[0]/a[0]) + z1};
-            z1 = input*(b[1]/a[0]) - output*(a[1]/a[0]) + z2;
-            z2 = input*(b[2]/a[0]) - output*(a[2]/a[0]);
+            const float output{input*coeffs.b0 + z1};
+            z1 = input*coeffs.b1 - output*coeffs.b1 + z2;
+            z2 = input*coeffs.b2 - output*coeffs.a2;
             mBufferOut[i] = output;
         }
         chandata->mFilter.z1 = z1;
@@ -23,8 +23,8 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <limits>
 #include <variant>
 #include <vector>
 
@@ -39,6 +39,7 @@
 #include "core/device.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
+#include "core/lfo.h"
 #include "core/mixer.h"
 #include "core/mixer/defs.h"
 #include "core/resampler_limits.h"
@@ -62,13 +63,14 @@ struct ChorusState final : public EffectState {
     std::vector<float> mDelayBuffer;
     uint mOffset{0};
 
-    uint mLfoOffset{0};
-    uint mLfoRange{1};
-    float mLfoScale{0.0f};
-    uint mLfoDisp{0};
+    Lfo mLfo;
+    /* Phase offsets of the left and right outputs' LFO. */
+    std::uint32_t mLfoOffset{0};
+    std::uint32_t mLfoDisp{0};
 
     /* Calculated delays to apply to the left and right outputs. */
     std::array<std::array<uint,BufferLineSize>,2> mModDelays{};
+    alignas(16) FloatBufferLine mLfoBuffer{};
 
     /* Temp storage for the modulated left and right outputs. */
     alignas(16) std::array<FloatBufferLine,2> mBuffer{};
@@ -86,8 +88,7 @@ struct ChorusState final : public EffectState {
     float mDepth{0.0f};
     float mFeedback{0.0f};
 
-    void calcTriangleDelays(const size_t todo);
-    void calcSinusoidDelays(const size_t todo);
+    void calcDelays(const size_t todo);
 
     void deviceUpdate(const DeviceBase *device, const float MaxDelay);
     void update(const ContextBase *context, const EffectSlot *slot, const ChorusWaveform waveform,
@@ -138,6 +139,9 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
         static_cast<float>(mDelay - mindelay));
 
     mFeedback = props.Feedback;
+    const auto maxdelay = static_cast<uint>(mDelay + float2int(std::ceil(mDepth)));
+    mTailLength = CalcFeedbackTail((maxdelay>>gCubicTable.sTableBits) + MaxResamplerEdge,
+        mFeedback);
 
     /* Gains for left and right sides */
     const bool ispairwise{device->mRenderMode == RenderMode::Pairwise};
@@ -152,114 +156,46 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
     ComputePanGains(target.Main, lcoeffs, gain, mGains[0].Target);
     ComputePanGains(target.Main, rcoeffs, gain, mGains[1].Target);
 
+    /* The triangle wave starts a quarter cycle back, so it begins at its
+     * lowest point.
+     */
+    mLfoOffset = (mWaveform == ChorusWaveform::Triangle) ? 0u-Lfo::QuarterCycle : 0u;
     if(!(props.Rate > 0.0f))
     {
-        mLfoOffset = 0;
-        mLfoRange = 1;
-        mLfoScale = 0.0f;
+        mLfo.setRate(0.0);
+        mLfo.setPhase(0u);
         mLfoDisp = 0;
     }
     else
     {
-        /* Calculate LFO coefficient (number of samples per cycle). Limit the
-         * max range to avoid overflow when calculating the displacement.
-         */
-        static constexpr int range_limit{std::numeric_limits<int>::max()/360 - 180};
-        const auto range = std::round(frequency / props.Rate);
-        const uint lfo_range{float2uint(std::min(range, float{range_limit}))};
-
-        mLfoOffset = mLfoOffset * lfo_range / mLfoRange;
-        mLfoRange = lfo_range;
-        switch(mWaveform)
-        {
-        case ChorusWaveform::Triangle:
-            mLfoScale = 4.0f / static_cast<float>(mLfoRange);
-            break;
-        case ChorusWaveform::Sinusoid:
-            mLfoScale = al::numbers::pi_v<float>*2.0f / static_cast<float>(mLfoRange);
-            break;
-        }
+        mLfo.setRate(props.Rate / frequency);
 
         /* Calculate lfo phase displacement */
         auto phase = props.Phase;
         if(phase < 0) phase += 360;
-        mLfoDisp = (mLfoRange*static_cast<uint>(phase) + 180) / 360;
+        mLfoDisp = Lfo::phaseFromCycles(phase / 360.0);
     }
 }
 
 
-void ChorusState::calcTriangleDelays(const size_t todo)
-{
-    const uint lfo_range{mLfoRange};
-    const float lfo_scale{mLfoScale};
-    const float depth{mDepth};
-    const int delay{mDelay};
-
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
-    {
-        const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i((1.0f-std::abs(2.0f-offset_norm)) * depth) + delay);
-    };
-
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
-}
-
-void ChorusState::calcSinusoidDelays(const size_t todo)
+void ChorusState::calcDelays(const size_t todo)
 {
-    const uint lfo_range{mLfoRange};
-    const float lfo_scale{mLfoScale};
+    const auto waveform = (mWaveform == ChorusWaveform::Sinusoid) ? LfoWaveform::Sinusoid
+        : LfoWaveform::Triangle;
     const float depth{mDepth};
     const int delay{mDelay};
 
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
-    {
-        const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i(std::sin(offset_norm)*depth) + delay);
-    };
+    auto gen_delay = [depth,delay](const float lfo) -> uint
+    { return static_cast<uint>(fastf2i(lfo*depth) + delay); };
 
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
+    const auto lfobuf = al::span{mLfoBuffer}.first(todo);
+    mLfo.generate(waveform, lfobuf, mLfoOffset);
+    std::transform(lfobuf.cbegin(), lfobuf.cend(), mModDelays[0].begin(), gen_delay);
 
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
+    mLfo.generate(waveform, lfobuf, mLfoOffset + mLfoDisp);
+    std::transform(lfobuf.cbegin(), lfobuf.cend(), mModDelays[1].begin(), gen_delay);
 
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
+    mLfo.advance(todo);
 }
 
 void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
@@ -270,10 +206,7 @@ void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBu
     const uint avgdelay{(static_cast<uint>(mDelay) + MixerFracHalf) >> MixerFracBits};
     uint offset{mOffset};
 
-    if(mWaveform == ChorusWaveform::Sinusoid)
-        calcSinusoidDelays(samplesToDo);
-    else /*if(mWaveform == ChorusWaveform::Triangle)*/
-        calcTriangleDelays(samplesToDo);
+    calcDelays(samplesToDo);
 
     const auto ldelays = al::span{mModDelays[0]};
     const auto rdelays = al::span{mModDelays[1]};
@@ -103,6 +103,8 @@ void CompressorState::update(const ContextBase*, const EffectSlot *slot,
     const EffectProps *props, const EffectTarget target)
 {
     mEnabled = std::get<CompressorProps>(*props).OnOff;
+    /* The output is only ever the input with a gain applied. */
+    mTailLength = 0;
 
     mOutTarget = target.Main->Buffer;
     auto set_channel = [this](size_t idx, uint outchan, float outgain)
@@ -304,6 +304,7 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
     decltype(mComplexData){}.swap(mComplexData);
 
     /* An empty buffer doesn't need a convolution filter. */
+    mTailLength = 0;
     if(!buffer || buffer->mSampleLen < 1) return;
 
     mChannels = buffer->mChannels;
@@ -343,6 +344,12 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
     mNumConvolveSegs = (resampledCount+(ConvolveUpdateSamples-1)) / ConvolveUpdateSamples;
     mNumConvolveSegs = std::max(mNumConvolveSegs, 2_uz) - 1_uz;
 
+    /* Output continues for the length of the response, plus the input FIFO
+     * and decoder delays.
+     */
+    mTailLength = static_cast<uint>((mNumConvolveSegs+2) * ConvolveUpdateSamples +
+        DecoderPadding);
+
     const size_t complex_length{mNumConvolveSegs * ConvolveUpdateSize * (numChannels+1)};
     mComplexData.resize(complex_length, 0.0f);
 
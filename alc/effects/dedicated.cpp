@@ -71,6 +71,7 @@ void DedicatedState::update(const ContextBase*, const EffectSlot *slot,
 
     auto &props = std::get<DedicatedProps>(*props_);
     const float Gain{slot->Gain * props.Gain};
+    mTailLength = 0;
 
     if(props.Target == DedicatedProps::Dialog)
     {
@@ -94,6 +94,8 @@ void DistortionState::update(const ContextBase *context, const EffectSlot *slot,
     /* Convert bandwidth in Hz to octaves. */
     bandwidth = props.EQBandwidth / (cutoff * 0.67f);
     mBandpass.setParamsFromBandwidth(BiquadType::BandPass, cutoff/frequency/4.0f, 1.0f, bandwidth);
+    /* Even the narrowest band-pass (80hz wide) settles within 100ms. */
+    mTailLength = device->Frequency / 10;
 
     static constexpr auto coeffs = CalcDirectionCoeffs(std::array{0.0f, 0.0f, -1.0f});
 
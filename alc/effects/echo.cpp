@@ -68,6 +68,7 @@ struct EchoState final : public EffectState {
     float mFeedGain{0.0f};
 
     alignas(16) std::array<FloatBufferLine,2> mTempBuffer{};
+    alignas(16) FloatBufferLine mFeedBuffer{};
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
@@ -81,9 +82,11 @@ void EchoState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
     const auto frequency = static_cast<float>(Device->Frequency);
 
     // Use the next power of 2 for the buffer length, so the tap offsets can be
-    // wrapped using a mask instead of a modulo
+    // wrapped using a mask instead of a modulo. Leave room for an update's
+    // worth of samples past the longest delay, so the taps being read never
+    // overlap with the samples being written.
     const uint maxlen{NextPowerOf2(float2uint(EchoMaxDelay*frequency + 0.5f) +
-        float2uint(EchoMaxLRDelay*frequency + 0.5f))};
+        float2uint(EchoMaxLRDelay*frequency + 0.5f) + uint{BufferLineSize})};
     if(maxlen != mSampleBuffer.size())
         decltype(mSampleBuffer)(maxlen).swap(mSampleBuffer);
 
@@ -109,6 +112,7 @@ void EchoState::update(const ContextBase *context, const EffectSlot *slot,
     mFilter.setParamsFromSlope(BiquadType::HighShelf, LowpassFreqRef/frequency, gainhf, 1.0f);
 
     mFeedGain = props.Feedback;
+    mTailLength = CalcFeedbackTail(static_cast<uint>(mDelayTap[1]), mFeedGain);
 
     /* Convert echo spread (where 0 = center, +/-1 = sides) to a 2D vector. */
     const float x{props.Spread}; /* +x = left */
@@ -132,31 +136,47 @@ void EchoState::process(const size_t samplesToDo, const al::span<const FloatBuff
 
     ASSUME(samplesToDo > 0);
 
-    const BiquadFilter filter{mFilter};
-    auto [z1, z2] = mFilter.getComponents();
-    for(size_t i{0u};i < samplesToDo;)
+    /* The delay buffer is processed in blocks no longer than the first tap's
+     * delay, so the delayed samples read for a block are never ones written
+     * for the same block. This lets each block read both taps, filter the
+     * second tap for feedback, and feed in the new input, one whole run at a
+     * time.
+     */
+    const size_t maxtodo{mDelayTap[0]};
+    const float feedgain{mFeedGain};
+    for(size_t base{0u};base < samplesToDo;)
     {
         offset &= mask;
         tap1 &= mask;
         tap2 &= mask;
 
-        size_t td{std::min(mask+1 - std::max(offset, std::max(tap1, tap2)), samplesToDo-i)};
-        do {
-            /* Feed the delay buffer's input first. */
-            delaybuf[offset] = samplesIn[0][i];
-
-            /* Get delayed output from the first and second taps. Use the
-             * second tap for feedback.
-             */
-            mTempBuffer[0][i] = delaybuf[tap1++];
-            mTempBuffer[1][i] = delaybuf[tap2++];
-            const float feedb{mTempBuffer[1][i++]};
-
-            /* Add feedback to the delay buffer with damping and attenuation. */
-            delaybuf[offset++] += filter.processOne(feedb, z1, z2) * mFeedGain;
-        } while(--td);
+        const size_t todo{std::min({mask+1 - std::max({offset, tap1, tap2}), samplesToDo-base,
+            maxtodo})};
+
+        /* Get delayed output from the first and second taps. Use the second
+         * tap for feedback.
+         */
+        const auto tapout1 = al::span{mTempBuffer[0]}.subspan(base, todo);
+        const auto tapout2 = al::span{mTempBuffer[1]}.subspan(base, todo);
+        std::copy_n(delaybuf.begin()+static_cast<ptrdiff_t>(tap1), todo, tapout1.begin());
+        std::copy_n(delaybuf.begin()+static_cast<ptrdiff_t>(tap2), todo, tapout2.begin());
+
+        /* Feed the delay buffer's input, with the feedback added after damping
+         * and attenuation.
+         */
+        const auto feedb = al::span{mFeedBuffer}.first(todo);
+        mFilter.process(tapout2, feedb);
+        const auto insamples = samplesIn[0].begin() + static_cast<ptrdiff_t>(base);
+        std::transform(feedb.cbegin(), feedb.cend(), insamples,
+            delaybuf.begin()+static_cast<ptrdiff_t>(offset),
+            [feedgain](const float feedback, const float input) noexcept -> float
+            { return input + feedback*feedgain; });
+
+        offset += todo;
+        tap1 += todo;
+        tap2 += todo;
+        base += todo;
     }
-    mFilter.setComponents(z1, z2);
     mOffset = offset;
 
     for(size_t c{0};c < 2;c++)
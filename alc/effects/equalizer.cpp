@@ -28,6 +28,8 @@
 #include <variant>
 
 #include "alc/effects/base.h"
+#include "alnumbers.h"
+#include "alnumeric.h"
 #include "alspan.h"
 #include "core/ambidefs.h"
 #include "core/bufferline.h"
@@ -149,6 +151,17 @@ void EqualizerState::update(const ContextBase *context, const EffectSlot *slot,
     f0norm = props.HighCutoff / frequency;
     mChans[0].mFilter[3].setParamsFromSlope(BiquadType::HighShelf, f0norm, gain, 0.75f);
 
+    /* The narrow peaking filters ring the longest, decaying by one neper
+     * every Q/(pi*f0) seconds. Allow enough time to reach -120dB.
+     */
+    auto ring_time = [](const float center, const float width) -> float
+    {
+        const float q{0.5f / std::sinh(std::log(2.0f)*0.5f*width)};
+        return q / (al::numbers::pi_v<float>*center) * 13.82f;
+    };
+    mTailLength = float2uint(frequency * std::max({ring_time(props.Mid1Center, props.Mid1Width),
+        ring_time(props.Mid2Center, props.Mid2Width), 0.1f}));
+
     /* Copy the filter coefficients for the other input channels. */
     for(size_t i{1u};i < slot->Wet.Buffer.size();++i)
     {
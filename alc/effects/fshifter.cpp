@@ -24,6 +24,7 @@
 #include <array>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
 #include <variant>
 
@@ -38,8 +39,9 @@
 #include "core/device.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
+#include "core/lfo.h"
 #include "core/mixer.h"
-#include "core/mixer/defs.h"
+#include "core/uhjfilter.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
 
@@ -79,17 +81,32 @@ struct FshifterState final : public EffectState {
     /* Effect parameters */
     size_t mCount{};
     size_t mPos{};
-    std::array<uint,2> mPhaseStep{};
-    std::array<uint,2> mPhase{};
-    std::array<double,2> mSign{};
+    std::array<Lfo,2> mLfo{};
+    std::array<float,2> mSign{};
+
+    /* Use the all-pass IIR filters for the analytic signal, instead of the
+     * FFT-based Hilbert transform.
+     */
+    bool mUseIIR{false};
 
     /* Effects buffers */
     std::array<double,HilSize> mInFIFO{};
     std::array<complex_d,HilStep> mOutFIFO{};
     std::array<complex_d,HilSize> mOutputAccum{};
     std::array<complex_d,HilSize> mAnalytic{};
-    std::array<complex_d,BufferLineSize> mOutdata{};
 
+    UhjAllPassFilter mFilterReal;
+    UhjAllPassFilter mFilterImag;
+    float mRealDelay{};
+
+    /* The real and imaginary components of the analytic signal. The real
+     * component has an extra sample for the IIR filter's delay.
+     */
+    alignas(16) std::array<float,BufferLineSize+1> mReal{};
+    alignas(16) FloatBufferLine mImag{};
+
+    alignas(16) FloatBufferLine mCos{};
+    alignas(16) FloatBufferLine mSin{};
     alignas(16) FloatBufferLine mBufferOut{};
 
     /* Effect gains for each output channel */
@@ -100,6 +117,9 @@ struct FshifterState final : public EffectState {
     std::array<OutGains,2> mGains;
 
 
+    void processFIR(const size_t samplesToDo, const al::span<const float> input);
+    void processIIR(const size_t samplesToDo, const al::span<const float> input);
+
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
@@ -107,20 +127,24 @@ struct FshifterState final : public EffectState {
         const al::span<FloatBufferLine> samplesOut) override;
 };
 
-void FshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
+void FshifterState::deviceUpdate(const DeviceBase *device, const BufferStorage*)
 {
     /* (Re-)initializing parameters and clear the buffers. */
     mCount = 0;
     mPos = HilSize - HilStep;
 
-    mPhaseStep.fill(0u);
-    mPhase.fill(0u);
-    mSign.fill(1.0);
+    mLfo.fill(Lfo{});
+    mSign.fill(1.0f);
+    mUseIIR = device->mFshifterIIR;
     mInFIFO.fill(0.0);
     mOutFIFO.fill(complex_d{});
     mOutputAccum.fill(complex_d{});
     mAnalytic.fill(complex_d{});
 
+    mFilterReal = UhjAllPassFilter{};
+    mFilterImag = UhjAllPassFilter{};
+    mRealDelay = 0.0f;
+
     for(auto &gain : mGains)
     {
         gain.Current.fill(0.0f);
@@ -134,36 +158,36 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     auto &props = std::get<FshifterProps>(*props_);
     const DeviceBase *device{context->mDevice};
 
-    const float step{props.Frequency / static_cast<float>(device->Frequency)};
-    mPhaseStep[0] = mPhaseStep[1] = fastf2u(std::min(step, 1.0f) * MixerFracOne);
+    /* The shift frequency can go up to the sample rate, so the phase step is
+     * set directly instead of being limited to an LFO rate. The rotation just
+     * aliases above half the sample rate.
+     */
+    const uint32_t step{Lfo::phaseFromCycles(std::min(props.Frequency
+        / static_cast<double>(device->Frequency), 1.0))};
 
-    switch(props.LeftDirection)
+    auto set_direction = [step](Lfo &lfo, float &sign, const FShifterDirection direction)
     {
-    case FShifterDirection::Down:
-        mSign[0] = -1.0;
-        break;
-    case FShifterDirection::Up:
-        mSign[0] = 1.0;
-        break;
-    case FShifterDirection::Off:
-        mPhase[0]     = 0;
-        mPhaseStep[0] = 0;
-        break;
-    }
+        switch(direction)
+        {
+        case FShifterDirection::Down:
+            lfo.setStep(step);
+            sign = -1.0f;
+            break;
+        case FShifterDirection::Up:
+            lfo.setStep(step);
+            sign = 1.0f;
+            break;
+        case FShifterDirection::Off:
+            lfo.setRate(0.0);
+            lfo.setPhase(0u);
+            break;
+        }
+    };
+    set_direction(mLfo[0], mSign[0], props.LeftDirection);
+    set_direction(mLfo[1], mSign[1], props.RightDirection);
 
-    switch(props.RightDirection)
-    {
-    case FShifterDirection::Down:
-        mSign[1] = -1.0;
-        break;
-    case FShifterDirection::Up:
-        mSign[1] = 1.0;
-        break;
-    case FShifterDirection::Off:
-        mPhase[1]     = 0;
-        mPhaseStep[1] = 0;
-        break;
-    }
+    /* Input is delayed through the FIR's input FIFO and output accumulator. */
+    mTailLength = HilSize*2;
 
     static constexpr auto inv_sqrt2 = static_cast<float>(1.0 / al::numbers::sqrt2);
     static constexpr auto lcoeffs_pw = CalcDirectionCoeffs(std::array{-1.0f, 0.0f, 0.0f});
@@ -178,7 +202,7 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     ComputePanGains(target.Main, rcoeffs, slot->Gain, mGains[1].Target);
 }
 
-void FshifterState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+void FshifterState::processFIR(const size_t samplesToDo, const al::span<const float> input)
 {
     for(size_t base{0u};base < samplesToDo;)
     {
@@ -188,8 +212,9 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         const size_t pos{mPos};
         size_t count{mCount};
         do {
-            mInFIFO[pos+count] = samplesIn[0][base];
-            mOutdata[base] = mOutFIFO[count];
+            mInFIFO[pos+count] = input[base];
+            mReal[base] = static_cast<float>(mOutFIFO[count].real());
+            mImag[base] = static_cast<float>(mOutFIFO[count].imag());
             ++base; ++count;
         } while(--todo);
         mCount = count;
@@ -218,25 +243,47 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         std::copy_n(mOutputAccum.cbegin() + mPos, HilStep, mOutFIFO.begin());
         std::fill_n(mOutputAccum.begin() + mPos, HilStep, complex_d{});
     }
+}
 
-    /* Process frequency shifter using the analytic signal obtained. */
+void FshifterState::processIIR(const size_t samplesToDo, const al::span<const float> input)
+{
+    /* The same all-pass pair used for UHJ makes a wide-band 90 degree phase
+     * difference between the two outputs, with only a few samples of latency.
+     * The real component's filter needs a 1-sample delay to line up with the
+     * imaginary component.
+     */
+    const auto insamples = input.first(samplesToDo);
+    mFilterReal.process(UhjAllPass1Coeffs, insamples, true, al::span{mReal}.subspan(1));
+    mReal[0] = mRealDelay; mRealDelay = mReal[samplesToDo];
+
+    mFilterImag.process(UhjAllPass2Coeffs, insamples, true, mImag);
+}
+
+void FshifterState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+{
+    if(mUseIIR)
+        processIIR(samplesToDo, samplesIn[0]);
+    else
+        processFIR(samplesToDo, samplesIn[0]);
+
+    /* Process frequency shifter using the analytic signal obtained. The FFT-
+     * based transform's overlap-add leaves its output at 3/4 the input level,
+     * so the IIR output is scaled to match.
+     */
+    const float gain{mUseIIR ? 0.75f : 1.0f};
+    const auto realdata = al::span{mReal}.first(samplesToDo);
+    const auto imagdata = al::span{mImag}.first(samplesToDo);
+    const auto cosdata = al::span{mCos}.first(samplesToDo);
+    const auto sindata = al::span{mSin}.first(samplesToDo);
     for(size_t c{0};c < 2;++c)
     {
-        const double sign{mSign[c]};
-        const uint phase_step{mPhaseStep[c]};
-        uint phase_idx{mPhase[c]};
-        std::transform(mOutdata.cbegin(), mOutdata.cbegin()+samplesToDo, mBufferOut.begin(),
-            [&phase_idx,phase_step,sign](const complex_d &in) -> float
-            {
-                const double phase{phase_idx * (al::numbers::pi*2.0 / MixerFracOne)};
-                const auto out = static_cast<float>(in.real()*std::cos(phase) +
-                    in.imag()*std::sin(phase)*sign);
-
-                phase_idx += phase_step;
-                phase_idx &= MixerFracMask;
-                return out;
-            });
-        mPhase[c] = phase_idx;
+        mLfo[c].generate(LfoWaveform::Sinusoid, cosdata, Lfo::QuarterCycle);
+        mLfo[c].generate(LfoWaveform::Sinusoid, sindata);
+        mLfo[c].advance(samplesToDo);
+
+        const float sign{mSign[c]};
+        for(size_t i{0};i < samplesToDo;++i)
+            mBufferOut[i] = (realdata[i]*cosdata[i] + imagdata[i]*sindata[i]*sign) * gain;
 
         /* Now, mix the processed sound data to the output. */
         MixSamples(al::span{mBufferOut}.first(samplesToDo), samplesOut, mGains[c].Current,
@@ -39,6 +39,7 @@
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/filters/biquad.h"
+#include "core/lfo.h"
 #include "core/mixer.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
@@ -49,33 +50,9 @@ namespace {
 
 using uint = unsigned int;
 
-struct SinFunc {
-    static auto Get(uint index, float scale) noexcept(noexcept(std::sin(0.0f))) -> float
-    { return std::sin(static_cast<float>(index) * scale); }
-};
-
-struct SawFunc {
-    static constexpr auto Get(uint index, float scale) noexcept -> float
-    { return static_cast<float>(index)*scale - 1.0f; }
-};
-
-struct SquareFunc {
-    static constexpr auto Get(uint index, float scale) noexcept -> float
-    { return float(static_cast<float>(index)*scale < 0.5f)*2.0f - 1.0f; }
-};
-
-struct OneFunc {
-    static constexpr auto Get(uint, float) noexcept -> float
-    { return 1.0f; }
-};
-
-
 struct ModulatorState final : public EffectState {
-    std::variant<OneFunc,SinFunc,SawFunc,SquareFunc> mSampleGen;
-
-    uint mIndex{0};
-    uint mRange{1};
-    float mIndexScale{0.0f};
+    Lfo mLfo;
+    LfoWaveform mWaveform{};
 
     alignas(16) FloatBufferLine mModSamples{};
     alignas(16) FloatBufferLine mBuffer{};
@@ -114,51 +91,32 @@ void ModulatorState::update(const ContextBase *context, const EffectSlot *slot,
     auto &props = std::get<ModulatorProps>(*props_);
     const DeviceBase *device{context->mDevice};
 
-    /* The effective frequency will be adjusted to have a whole number of
-     * samples per cycle (at 48khz, that allows 8000, 6857.14, 6000, 5333.33,
-     * 4800, etc). We could do better by using fixed-point stepping over a sin
-     * function, with additive synthesis for the square and sawtooth waveforms,
-     * but that may need a more efficient sin function since it needs to do
-     * many iterations per sample.
+    /* A frequency of 0 leaves the LFO stopped at its starting phase, which is
+     * the peak of the square wave, so the input passes through unmodulated.
      */
-    const float samplesPerCycle{props.Frequency > 0.0f
-        ? static_cast<float>(device->Frequency)/props.Frequency + 0.5f
-        : 1.0f};
-    const uint range{static_cast<uint>(std::clamp(samplesPerCycle, 1.0f,
-        static_cast<float>(device->Frequency)))};
-    mIndex = static_cast<uint>(uint64_t{mIndex} * range / mRange);
-    mRange = range;
-
-    if(mRange == 1)
+    const float rate{props.Frequency / static_cast<float>(device->Frequency)};
+    if(!(rate > 0.0f))
     {
-        mIndexScale = 0.0f;
-        mSampleGen.emplace<OneFunc>();
+        mWaveform = LfoWaveform::Square;
+        mLfo.setRate(0.0);
+        mLfo.setPhase(0u);
     }
-    else if(props.Waveform == ModulatorWaveform::Sinusoid)
+    else
     {
-        mIndexScale = al::numbers::pi_v<float>*2.0f / static_cast<float>(mRange);
-        mSampleGen.emplace<SinFunc>();
-    }
-    else if(props.Waveform == ModulatorWaveform::Sawtooth)
-    {
-        mIndexScale = 2.0f / static_cast<float>(mRange-1);
-        mSampleGen.emplace<SawFunc>();
-    }
-    else if(props.Waveform == ModulatorWaveform::Square)
-    {
-        /* For square wave, the range should be even (there should be an equal
-         * number of high and low samples). An odd number of samples per cycle
-         * would need a more complex value generator.
-         */
-        mRange = (mRange+1) & ~1u;
-        mIndexScale = 1.0f / static_cast<float>(mRange-1);
-        mSampleGen.emplace<SquareFunc>();
+        if(props.Waveform == ModulatorWaveform::Sinusoid)
+            mWaveform = LfoWaveform::Sinusoid;
+        else if(props.Waveform == ModulatorWaveform::Sawtooth)
+            mWaveform = LfoWaveform::Sawtooth;
+        else /*if(props.Waveform == ModulatorWaveform::Square)*/
+            mWaveform = LfoWaveform::Square;
+        mLfo.setRate(std::min(rate, 0.5f));
     }
 
     float f0norm{props.HighPassCutoff / static_cast<float>(device->Frequency)};
     f0norm = std::clamp(f0norm, 1.0f/512.0f, 0.49f);
     /* Bandwidth value is constant in octaves. */
     mChans[0].mFilter.setParamsFromBandwidth(BiquadType::HighPass, f0norm, 1.0f, 0.75f);
+    mTailLength = device->Frequency / 10;
     for(size_t i{1u};i < slot->Wet.Buffer.size();++i)
         mChans[i].mFilter.copyParamsFrom(mChans[0].mFilter);
 
@@ -175,25 +133,8 @@ void ModulatorState::process(const size_t samplesToDo, const al::span<const Floa
 {
     ASSUME(samplesToDo > 0);
 
-    std::visit([this,samplesToDo](auto&& type)
-    {
-        const uint range{mRange};
-        const float scale{mIndexScale};
-        uint index{mIndex};
-
-        ASSUME(range > 1);
-
-        for(size_t i{0};i < samplesToDo;)
-        {
-            size_t rem{std::min(samplesToDo-i, size_t{range-index})};
-            do {
-                mModSamples[i++] = type.Get(index++, scale);
-            } while(--rem);
-            if(index == range)
-                index = 0;
-        }
-        mIndex = index;
-    }, mSampleGen);
+    mLfo.generate(mWaveform, al::span{mModSamples}.first(samplesToDo));
+    mLfo.advance(samplesToDo);
 
     auto chandata = mChans.begin();
     for(const auto &input : samplesIn)
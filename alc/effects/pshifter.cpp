@@ -24,7 +24,9 @@
 #include <array>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <variant>
 
 #include "alc/effects/base.h"
@@ -50,29 +52,57 @@ namespace {
 using uint = unsigned int;
 using complex_f = std::complex<float>;
 
+/* The high quality STFT size and overlap. The medium quality uses half the
+ * size and overlap, trading frequency and phase resolution for about a
+ * quarter of the cost.
+ */
 constexpr size_t StftSize{1024};
 constexpr size_t StftHalfSize{StftSize >> 1};
 constexpr size_t OversampleFactor{8};
 
+constexpr size_t MediumStftSize{StftSize >> 1};
+constexpr size_t MediumOversampleFactor{OversampleFactor >> 1};
+
 static_assert(StftSize%OversampleFactor == 0, "Factor must be a clean divisor of the size");
-constexpr size_t StftStep{StftSize / OversampleFactor};
+static_assert(MediumStftSize%MediumOversampleFactor == 0,
+    "Factor must be a clean divisor of the size");
+
+/* The low quality time-domain shifter's grain length, the range of delays
+ * searched for the best match when starting a grain, and the number of
+ * samples compared for each delay.
+ */
+constexpr size_t GrainLength{1024};
+constexpr size_t GrainSearchLength{256};
+constexpr size_t GrainMatchLength{64};
+/* The minimum tap delay, so reading with interpolation never passes the
+ * input.
+ */
+constexpr size_t GrainMinDelay{1};
+/* Enough for the longest starting delay (when raising the pitch by an octave),
+ * and the samples before it used for matching.
+ */
+constexpr size_t DelayLineSize{2048};
+static_assert(GrainLength + GrainMinDelay + GrainSearchLength + GrainMatchLength
+    <= DelayLineSize, "Delay line too small for the grain parameters");
 
 /* Define a Hann window, used to filter the STFT input and output. */
+template<size_t N>
 struct Windower {
-    alignas(16) std::array<float,StftSize> mData{};
+    alignas(16) std::array<float,N> mData{};
 
     Windower()
     {
         /* Create lookup table of the Hann window for the desired size. */
-        for(size_t i{0};i < StftHalfSize;i++)
+        for(size_t i{0};i < N/2;i++)
         {
-            constexpr double scale{al::numbers::pi / double{StftSize}};
+            constexpr double scale{al::numbers::pi / double{N}};
             const double val{std::sin((static_cast<double>(i)+0.5) * scale)};
-            mData[i] = mData[StftSize-1-i] = static_cast<float>(val * val);
+            mData[i] = mData[N-1-i] = static_cast<float>(val * val);
         }
     }
 };
-const Windower gWindow{};
+const Windower<StftSize> gWindow{};
+const Windower<MediumStftSize> gMediumWindow{};
 
 
 struct FrequencyBin {
@@ -87,6 +117,14 @@ struct PshifterState final : public EffectState {
     size_t mPos{};
     uint mPitchShiftI{};
     float mPitchShift{};
+    PshifterQuality mQuality{};
+
+    /* STFT parameters for the current quality. */
+    size_t mStftSize{};
+    size_t mStftStep{};
+    size_t mOversample{};
+    al::span<const float> mWindow;
+    const PFFFTSetup *mCurrentFft{};
 
     /* Effects buffers */
     std::array<float,StftSize> mFIFO{};
@@ -95,12 +133,21 @@ struct PshifterState final : public EffectState {
     std::array<float,StftSize> mOutputAccum{};
 
     PFFFTSetup mFft;
+    PFFFTSetup mMediumFft;
     alignas(16) std::array<float,StftSize> mFftBuffer{};
     alignas(16) std::array<float,StftSize> mFftWorkBuffer{};
 
     std::array<FrequencyBin,StftHalfSize+1> mAnalysisBuffer{};
     std::array<FrequencyBin,StftHalfSize+1> mSynthesisBuffer{};
 
+    /* Time-domain shifter state. The taps' read positions have MixerFracBits
+     * of fractional precision.
+     */
+    std::array<float,DelayLineSize> mDelayLine{};
+    size_t mDelayPos{};
+    size_t mGrainCount{};
+    std::array<size_t,2> mTapPos{};
+
     alignas(16) FloatBufferLine mBufferOut{};
 
     /* Effect gains for each output channel */
@@ -108,6 +155,11 @@ struct PshifterState final : public EffectState {
     std::array<float,MaxAmbiChannels> mTargetGains{};
 
 
+    void setQuality(const PshifterQuality quality);
+    void processStft(const size_t samplesToDo, const al::span<const float> input);
+    void startGrain(const size_t tap);
+    void processTimeDomain(const size_t samplesToDo, const al::span<const float> input);
+
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
@@ -115,13 +167,30 @@ struct PshifterState final : public EffectState {
         const al::span<FloatBufferLine> samplesOut) override;
 };
 
-void PshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
+/* Sets up the processing for the given quality, and clears the buffers. This
+ * is done in the mixer when the quality changes, so it mustn't allocate.
+ */
+void PshifterState::setQuality(const PshifterQuality quality)
 {
-    /* (Re-)initializing parameters and clear the buffers. */
-    mCount       = 0;
-    mPos         = StftSize - StftStep;
-    mPitchShiftI = MixerFracOne;
-    mPitchShift  = 1.0f;
+    mQuality = quality;
+    if(quality == PshifterQuality::Medium)
+    {
+        mStftSize = MediumStftSize;
+        mOversample = MediumOversampleFactor;
+        mWindow = gMediumWindow.mData;
+        mCurrentFft = &mMediumFft;
+    }
+    else
+    {
+        mStftSize = StftSize;
+        mOversample = OversampleFactor;
+        mWindow = gWindow.mData;
+        mCurrentFft = &mFft;
+    }
+    mStftStep = mStftSize / mOversample;
+
+    mCount = 0;
+    mPos = mStftSize - mStftStep;
 
     mFIFO.fill(0.0f);
     mLastPhase.fill(0.0f);
@@ -131,11 +200,27 @@ void PshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
     mAnalysisBuffer.fill(FrequencyBin{});
     mSynthesisBuffer.fill(FrequencyBin{});
 
+    mDelayLine.fill(0.0f);
+    mDelayPos = 0;
+    mGrainCount = 0;
+    mTapPos.fill(0);
+}
+
+void PshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
+{
+    /* (Re-)initializing parameters and clear the buffers. */
+    mPitchShiftI = MixerFracOne;
+    mPitchShift  = 1.0f;
+
     mCurrentGains.fill(0.0f);
     mTargetGains.fill(0.0f);
 
     if(!mFft)
         mFft = PFFFTSetup{StftSize, PFFFT_REAL};
+    if(!mMediumFft)
+        mMediumFft = PFFFTSetup{MediumStftSize, PFFFT_REAL};
+
+    setQuality(PshifterQuality::High);
 }
 
 void PshifterState::update(const ContextBase*, const EffectSlot *slot,
@@ -148,27 +233,39 @@ void PshifterState::update(const ContextBase*, const EffectSlot *slot,
         uint{MixerFracOne}*2u);
     mPitchShift  = static_cast<float>(mPitchShiftI) * float{1.0f/MixerFracOne};
 
+    if(props.Quality != mQuality)
+        setQuality(props.Quality);
+
     static constexpr auto coeffs = CalcDirectionCoeffs(std::array{0.0f, 0.0f, -1.0f});
 
+    /* The STFT holds up to a frame of input and a frame of output, and the
+     * time-domain grains read up to the full delay line back.
+     */
+    mTailLength = static_cast<uint>(std::max(StftSize*2, DelayLineSize+GrainLength));
+
     mOutTarget = target.Main->Buffer;
     ComputePanGains(target.Main, coeffs, slot->Gain, mTargetGains);
 }
 
-void PshifterState::process(const size_t samplesToDo,
-    const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+void PshifterState::processStft(const size_t samplesToDo, const al::span<const float> input)
 {
     /* Pitch shifter engine based on the work of Stephan Bernsee.
      * http://blogs.zynaptiq.com/bernsee/pitch-shifting-using-the-ft/
      */
+    const size_t stft_size{mStftSize};
+    const size_t stft_half_size{stft_size >> 1};
+    const size_t stft_step{mStftStep};
+    const size_t oversample{mOversample};
+    const auto window = mWindow;
 
     /* Cycle offset per update expected of each frequency bin (bin 0 is none,
      * bin 1 is x1, bin 2 is x2, etc).
      */
-    constexpr float expected_cycles{al::numbers::pi_v<float>*2.0f / OversampleFactor};
+    const float expected_cycles{al::numbers::pi_v<float>*2.0f / static_cast<float>(oversample)};
 
     for(size_t base{0u};base < samplesToDo;)
     {
-        const size_t todo{std::min(StftStep-mCount, samplesToDo-base)};
+        const size_t todo{std::min(stft_step-mCount, samplesToDo-base)};
 
         /* Retrieve the output samples from the FIFO and fill in the new input
          * samples.
@@ -176,32 +273,32 @@ void PshifterState::process(const size_t samplesToDo,
         auto fifo_iter = mFIFO.begin()+mPos + mCount;
         std::copy_n(fifo_iter, todo, mBufferOut.begin()+base);
 
-        std::copy_n(samplesIn[0].begin()+base, todo, fifo_iter);
+        std::copy_n(input.begin()+base, todo, fifo_iter);
         mCount += todo;
         base += todo;
 
         /* Check whether FIFO buffer is filled with new samples. */
-        if(mCount < StftStep) break;
+        if(mCount < stft_step) break;
         mCount = 0;
-        mPos = (mPos+StftStep) & (mFIFO.size()-1);
+        mPos = (mPos+stft_step) & (stft_size-1);
 
         /* Time-domain signal windowing, store in FftBuffer, and apply a
          * forward FFT to get the frequency-domain signal.
          */
-        for(size_t src{mPos}, k{0u};src < StftSize;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
-        for(size_t src{0u}, k{StftSize-mPos};src < mPos;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
-        mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
-            PFFFT_FORWARD);
+        for(size_t src{mPos}, k{0u};src < stft_size;++src,++k)
+            mFftBuffer[k] = mFIFO[src] * window[k];
+        for(size_t src{0u}, k{stft_size-mPos};src < mPos;++src,++k)
+            mFftBuffer[k] = mFIFO[src] * window[k];
+        mCurrentFft->transform_ordered(mFftBuffer.data(), mFftBuffer.data(),
+            mFftWorkBuffer.data(), PFFFT_FORWARD);
 
         /* Analyze the obtained data. Since the real FFT is symmetric, only
-         * StftHalfSize+1 samples are needed.
+         * stft_half_size+1 samples are needed.
          */
-        for(size_t k{0u};k < StftHalfSize+1;++k)
+        for(size_t k{0u};k < stft_half_size+1;++k)
         {
             const auto cplx = (k == 0) ? complex_f{mFftBuffer[0]} :
-                (k == StftHalfSize) ? complex_f{mFftBuffer[1]} :
+                (k == stft_half_size) ? complex_f{mFftBuffer[1]} :
                 complex_f{mFftBuffer[k*2], mFftBuffer[k*2 + 1]};
             const float magnitude{std::abs(cplx)};
             const float phase{std::arg(cplx)};
@@ -210,10 +307,10 @@ void PshifterState::process(const size_t samplesToDo,
              * the expected phase difference for this bin.
              *
              * When oversampling, the expected per-update offset increments by
-             * 1/OversampleFactor for every frequency bin. So, the offset wraps
-             * every 'OversampleFactor' bin.
+             * 1/oversample for every frequency bin. So, the offset wraps every
+             * 'oversample' bin.
              */
-            const auto bin_offset = static_cast<float>(k % OversampleFactor);
+            const auto bin_offset = static_cast<float>(k % oversample);
             float tmp{(phase - mLastPhase[k]) - bin_offset*expected_cycles};
             /* Store the actual phase for the next update. */
             mLastPhase[k] = phase;
@@ -226,7 +323,7 @@ void PshifterState::process(const size_t samplesToDo,
             /* Get deviation from bin frequency (-0.5 to +0.5), and account for
              * oversampling.
              */
-            tmp *= 0.5f * OversampleFactor;
+            tmp *= 0.5f * static_cast<float>(oversample);
 
             /* Compute the k-th partials' frequency bin target and store the
              * magnitude and frequency bin in the analysis buffer. We don't
@@ -240,10 +337,10 @@ void PshifterState::process(const size_t samplesToDo,
         /* Shift the frequency bins according to the pitch adjustment,
          * accumulating the magnitudes of overlapping frequency bins.
          */
-        std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
+        std::fill_n(mSynthesisBuffer.begin(), stft_half_size+1, FrequencyBin{});
 
-        static constexpr size_t bin_limit{((StftHalfSize+1)<<MixerFracBits) - MixerFracHalf - 1};
-        const size_t bin_count{std::min(StftHalfSize+1, bin_limit/mPitchShiftI + 1)};
+        const size_t bin_limit{((stft_half_size+1)<<MixerFracBits) - MixerFracHalf - 1};
+        const size_t bin_count{std::min(stft_half_size+1, bin_limit/mPitchShiftI + 1)};
         for(size_t k{0u};k < bin_count;k++)
         {
             const size_t j{(k*mPitchShiftI + MixerFracHalf) >> MixerFracBits};
@@ -260,7 +357,7 @@ void PshifterState::process(const size_t samplesToDo,
         /* Reconstruct the frequency-domain signal from the adjusted frequency
          * bins.
          */
-        for(size_t k{0u};k < StftHalfSize+1;k++)
+        for(size_t k{0u};k < stft_half_size+1;k++)
         {
             /* Calculate the actual delta phase for this bin's target frequency
              * bin, and accumulate it to get the actual bin phase.
@@ -279,7 +376,7 @@ void PshifterState::process(const size_t samplesToDo,
             const complex_f cplx{std::polar(mSynthesisBuffer[k].Magnitude, mSumPhase[k])};
             if(k == 0)
                 mFftBuffer[0] = cplx.real();
-            else if(k == StftHalfSize)
+            else if(k == stft_half_size)
                 mFftBuffer[1] = cplx.real();
             else
             {
@@ -291,19 +388,127 @@ void PshifterState::process(const size_t samplesToDo,
         /* Apply an inverse FFT to get the time-domain signal, and accumulate
          * for the output with windowing.
          */
-        mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
-            PFFFT_BACKWARD);
+        mCurrentFft->transform_ordered(mFftBuffer.data(), mFftBuffer.data(),
+            mFftWorkBuffer.data(), PFFFT_BACKWARD);
 
-        static constexpr float scale{3.0f / OversampleFactor / StftSize};
-        for(size_t dst{mPos}, k{0u};dst < StftSize;++dst,++k)
-            mOutputAccum[dst] += gWindow.mData[k]*mFftBuffer[k] * scale;
-        for(size_t dst{0u}, k{StftSize-mPos};dst < mPos;++dst,++k)
-            mOutputAccum[dst] += gWindow.mData[k]*mFftBuffer[k] * scale;
+        const float scale{3.0f / static_cast<float>(oversample) / static_cast<float>(stft_size)};
+        for(size_t dst{mPos}, k{0u};dst < stft_size;++dst,++k)
+            mOutputAccum[dst] += window[k]*mFftBuffer[k] * scale;
+        for(size_t dst{0u}, k{stft_size-mPos};dst < mPos;++dst,++k)
+            mOutputAccum[dst] += window[k]*mFftBuffer[k] * scale;
 
         /* Copy out the accumulated result, then clear for the next iteration. */
-        std::copy_n(mOutputAccum.begin() + mPos, StftStep, mFIFO.begin() + mPos);
-        std::fill_n(mOutputAccum.begin() + mPos, StftStep, 0.0f);
+        std::copy_n(mOutputAccum.begin() + mPos, stft_step, mFIFO.begin() + mPos);
+        std::fill_n(mOutputAccum.begin() + mPos, stft_step, 0.0f);
     }
+}
+
+/* Starts a new grain for the given tap, as it's about to fade in. The tap
+ * needs to start far enough back that it stays behind the input for the whole
+ * grain. Within a range past that, the delay whose preceding samples best
+ * match those of the other tap (which is at full volume) is picked, so the two
+ * are more in phase as they cross-fade.
+ */
+void PshifterState::startGrain(const size_t tap)
+{
+    static constexpr size_t mask{DelayLineSize-1};
+    const auto delayline = al::span{mDelayLine};
+    const size_t pos{mDelayPos};
+
+    /* Raising the pitch makes the delay shrink as the tap reads faster than
+     * the input is written.
+     */
+    size_t mindelay{GrainMinDelay};
+    if(mPitchShiftI > MixerFracOne)
+        mindelay += ((mPitchShiftI-MixerFracOne)*GrainLength + MixerFracMask) >> MixerFracBits;
+
+    const size_t otherpos{mTapPos[tap^1] >> MixerFracBits};
+
+    size_t bestdelay{mindelay};
+    float bestcorr{-std::numeric_limits<float>::infinity()};
+    for(size_t delay{mindelay};delay < mindelay+GrainSearchLength;++delay)
+    {
+        float corr{0.0f};
+        for(size_t i{1};i <= GrainMatchLength;++i)
+            corr += delayline[(pos-delay-i) & mask] * delayline[(otherpos-i) & mask];
+        if(corr > bestcorr)
+        {
+            bestcorr = corr;
+            bestdelay = delay;
+        }
+    }
+    mTapPos[tap] = (pos-bestdelay) << MixerFracBits;
+}
+
+void PshifterState::processTimeDomain(const size_t samplesToDo, const al::span<const float> input)
+{
+    /* A WSOLA-style time-domain pitch shifter. Two taps read from the delay
+     * line at the shifted rate, with triangular windows half a grain apart so
+     * one fades in as the other fades out. Each time a tap is silent, it
+     * starts a new grain, jumping back to a delay that stays behind the input
+     * and best matches the other tap.
+     */
+    static constexpr size_t mask{DelayLineSize-1};
+    static constexpr size_t HalfGrain{GrainLength / 2};
+    static constexpr float GainScale{1.0f / float{HalfGrain}};
+    const auto delayline = al::span{mDelayLine};
+    const size_t pitchstep{mPitchShiftI};
+
+    auto read_tap = [delayline](const size_t tappos) noexcept -> float
+    {
+        const size_t idx{(tappos >> MixerFracBits) & mask};
+        const auto frac = static_cast<float>(tappos & MixerFracMask) * (1.0f/MixerFracOne);
+        return lerpf(delayline[idx], delayline[(idx+1) & mask], frac);
+    };
+
+    for(size_t base{0u};base < samplesToDo;)
+    {
+        /* The first tap's grain starts at count 0, and the second tap's grain
+         * starts halfway.
+         */
+        const size_t count{mGrainCount};
+        if(count == 0)
+            startGrain(0);
+        else if(count == HalfGrain)
+            startGrain(1);
+
+        const size_t todo{std::min(HalfGrain - (count&(HalfGrain-1)), samplesToDo-base)};
+        /* In the first half, the first tap fades in and the second fades out.
+         * It's the other way around in the second half.
+         */
+        const size_t fadein{(count < HalfGrain) ? 0u : 1u};
+        size_t fadeinpos{mTapPos[fadein]};
+        size_t fadeoutpos{mTapPos[fadein^1]};
+        size_t pos{mDelayPos};
+        size_t step{count & (HalfGrain-1)};
+
+        const auto output = al::span{mBufferOut}.subspan(base, todo);
+        const auto insamples = input.subspan(base, todo);
+        for(size_t i{0u};i < todo;++i)
+        {
+            delayline[pos] = insamples[i];
+            pos = (pos+1) & mask;
+
+            const float gain{static_cast<float>(step++) * GainScale};
+            output[i] = read_tap(fadeinpos)*gain + read_tap(fadeoutpos)*(1.0f-gain);
+            fadeinpos += pitchstep;
+            fadeoutpos += pitchstep;
+        }
+        mTapPos[fadein] = fadeinpos;
+        mTapPos[fadein^1] = fadeoutpos;
+        mDelayPos = pos;
+        mGrainCount = (count+todo) & (GrainLength-1);
+        base += todo;
+    }
+}
+
+void PshifterState::process(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+{
+    if(mQuality == PshifterQuality::Low)
+        processTimeDomain(samplesToDo, samplesIn[0]);
+    else
+        processStft(samplesToDo, samplesIn[0]);
 
     /* Now, mix the processed sound data to the output. */
     MixSamples(al::span{mBufferOut}.first(samplesToDo), samplesOut, mCurrentGains, mTargetGains,
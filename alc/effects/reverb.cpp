@@ -1255,6 +1255,14 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
     pipeline.updateDelayLine(props.Gain, props.ReflectionsDelay, props.LateReverbDelay,
         density_mult, props.DecayTime, frequency);
 
+    /* The decay time is to -60dB, so twice the longest one gets the late
+     * reverb to -120dB. Include the initial delays, and some slack for the
+     * feedback delay lines themselves.
+     */
+    const float maxDecayTime{std::max({props.DecayTime, lfDecayTime, hfDecayTime})};
+    mTailLength = float2uint(frequency * (maxDecayTime*2.0f + props.ReflectionsDelay +
+        props.LateReverbDelay + 0.5f));
+
     /* Update early and late 3D panning. */
     mOutTarget = target.Main->Buffer;
     const float gain{Slot->Gain * ReverbBoost};
@@ -49,6 +49,7 @@
 #include "core/device.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
+#include "core/lfo.h"
 #include "core/mixer.h"
 #include "intrusive_ptr.h"
 
@@ -67,35 +68,6 @@ enum : size_t {
     NumFilters
 };
 
-constexpr size_t WaveformFracBits{24};
-constexpr size_t WaveformFracOne{1<<WaveformFracBits};
-constexpr size_t WaveformFracMask{WaveformFracOne-1};
-
-inline float Sin(uint index)
-{
-    constexpr float scale{al::numbers::pi_v<float>*2.0f / float{WaveformFracOne}};
-    return std::sin(static_cast<float>(index) * scale)*0.5f + 0.5f;
-}
-
-inline float Saw(uint index)
-{ return static_cast<float>(index) / float{WaveformFracOne}; }
-
-inline float Triangle(uint index)
-{ return std::fabs(static_cast<float>(index)*(2.0f/WaveformFracOne) - 1.0f); }
-
-inline float Half(uint) { return 0.5f; }
-
-template<float (&func)(uint)>
-void Oscillate(const al::span<float> dst, uint index, const uint step)
-{
-    std::generate(dst.begin(), dst.end(), [&index,step]
-    {
-        index += step;
-        index &= WaveformFracMask;
-        return func(index);
-    });
-}
-
 struct FormantFilter {
     float mCoeff{0.0f};
     float mGain{1.0f};
@@ -159,15 +131,13 @@ struct VmorpherState final : public EffectState {
     };
     std::array<OutParams,MaxAmbiChannels> mChans;
 
-    void (*mGetSamples)(const al::span<float> dst, uint index, const uint step){};
-
-    uint mIndex{0};
-    uint mStep{1};
+    Lfo mLfo;
+    LfoWaveform mWaveform{};
 
     /* Effects buffers */
     alignas(16) std::array<float,MaxUpdateSamples> mSampleBufferA{};
     alignas(16) std::array<float,MaxUpdateSamples> mSampleBufferB{};
-    alignas(16) std::array<float,MaxUpdateSamples> mLfo{};
+    alignas(16) std::array<float,MaxUpdateSamples> mLfoBuffer{};
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
@@ -250,17 +220,22 @@ void VmorpherState::update(const ContextBase *context, const EffectSlot *slot,
     auto &props = std::get<VmorpherProps>(*props_);
     const DeviceBase *device{context->mDevice};
     const float frequency{static_cast<float>(device->Frequency)};
-    const float step{props.Rate / frequency};
-    mStep = fastf2u(std::clamp(step*WaveformFracOne, 0.0f, WaveformFracOne-1.0f));
-
-    if(mStep == 0)
-        mGetSamples = Oscillate<Half>;
+    /* The sinusoid starts halfway between the two vowels and the sawtooth
+     * starts at the first, while the triangle is offset by a quarter cycle to
+     * start at the second. With no rate, the LFO stays halfway.
+     */
+    mLfo.setRate(props.Rate / frequency);
+    if(!mLfo.isRunning())
+    {
+        mWaveform = LfoWaveform::Sinusoid;
+        mLfo.setPhase(0u);
+    }
     else if(props.Waveform == VMorpherWaveform::Sinusoid)
-        mGetSamples = Oscillate<Sin>;
+        mWaveform = LfoWaveform::Sinusoid;
     else if(props.Waveform == VMorpherWaveform::Triangle)
-        mGetSamples = Oscillate<Triangle>;
+        mWaveform = LfoWaveform::Triangle;
     else /*if(props.Waveform == VMorpherWaveform::Sawtooth)*/
-        mGetSamples = Oscillate<Saw>;
+        mWaveform = LfoWaveform::Sawtooth;
 
     const float pitchA{std::pow(2.0f, static_cast<float>(props.PhonemeACoarseTuning) / 12.0f)};
     const float pitchB{std::pow(2.0f, static_cast<float>(props.PhonemeBCoarseTuning) / 12.0f)};
@@ -275,6 +250,11 @@ void VmorpherState::update(const ContextBase *context, const EffectSlot *slot,
         std::copy(vowelB.begin(), vowelB.end(), mChans[i].mFormants[VowelBIndex].begin());
     }
 
+    /* The formant filters have a Q of 5, and may be tuned down to a couple
+     * octaves below the lowest vowel formant.
+     */
+    mTailLength = device->Frequency / 2;
+
     mOutTarget = target.Main->Buffer;
     auto set_channel = [this](size_t idx, uint outchan, float outgain)
     {
@@ -295,9 +275,13 @@ void VmorpherState::process(const size_t samplesToDo, const al::span<const Float
     {
         const size_t td{std::min(MaxUpdateSamples, samplesToDo-base)};
 
-        mGetSamples(al::span{mLfo}.first(td), mIndex, mStep);
-        mIndex += static_cast<uint>(mStep * td);
-        mIndex &= WaveformFracMask;
+        /* Scale the LFO to blend from 0 to 1. */
+        const auto lfo = al::span{mLfoBuffer}.first(td);
+        mLfo.generate(mWaveform, lfo,
+            (mWaveform == LfoWaveform::Triangle) ? Lfo::QuarterCycle : 0u);
+        mLfo.advance(td);
+        std::transform(lfo.cbegin(), lfo.cend(), lfo.begin(),
+            [](const float val) noexcept { return val*0.5f + 0.5f; });
 
         auto chandata = mChans.begin();
         for(const auto &input : samplesIn)
@@ -327,7 +311,7 @@ void VmorpherState::process(const size_t samplesToDo, const al::span<const Float
             vowelB[3].process(&input[base], mSampleBufferB.data(), td);
 
             for(size_t i{0u};i < td;i++)
-                blended[i] = lerpf(mSampleBufferA[i], mSampleBufferB[i], mLfo[i]);
+                blended[i] = lerpf(mSampleBufferA[i], mSampleBufferB[i], lfo[i]);
 
             /* Now, mix the processed sound data to the output. */
             MixSamples(al::span{blended}.first(td), al::span{samplesOut[outidx]}.subspan(base),
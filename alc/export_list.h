@@ -46,6 +46,7 @@ inline const FuncExport alcFunctions[]{
     DECL(alcLoopbackOpenDeviceSOFT),
     DECL(alcIsRenderFormatSupportedSOFT),
     DECL(alcRenderSamplesSOFT),
+    DECL(alcRenderSamplesPlanarSOFT),
 
     DECL(alcDevicePauseSOFT),
     DECL(alcDeviceResumeSOFT),
@@ -184,6 +185,7 @@ inline const FuncExport alcFunctions[]{
     DECL(alGetSourcei64SOFT),
     DECL(alGetSource3i64SOFT),
     DECL(alGetSourcei64vSOFT),
+    DECL(alGetSourceStatesSOFT),
 
     DECL(alGetStringiSOFT),
 
@@ -194,6 +196,8 @@ inline const FuncExport alcFunctions[]{
 
     DECL(alEventControlSOFT),
     DECL(alEventCallbackSOFT),
+    DECL(alEventBatchCallbackSOFT),
+    DECL(alPollEventsSOFT),
     DECL(alGetPointerSOFT),
     DECL(alGetPointervSOFT),
 
@@ -204,6 +208,12 @@ inline const FuncExport alcFunctions[]{
 
     DECL(alSourcePlayAtTimeSOFT),
     DECL(alSourcePlayAtTimevSOFT),
+    DECL(alSourceStopAtTimeSOFT),
+    DECL(alSourceStopAtTimevSOFT),
+    DECL(alSourcePauseAtTimeSOFT),
+    DECL(alSourcePauseAtTimevSOFT),
+    DECL(alSourceRampGainAtTimeSOFT),
+    DECL(alSourceRampGainAtTimevSOFT),
 
     DECL(alBufferSubDataSOFT),
 
@@ -350,14 +360,23 @@ inline const FuncExport alcFunctions[]{
     DECL(alGetSourcei64DirectSOFT),
     DECL(alGetSource3i64DirectSOFT),
     DECL(alGetSourcei64vDirectSOFT),
+    DECL(alGetSourceStatesDirectSOFT),
     DECL(alGetSourcedDirectSOFT),
     DECL(alGetSource3dDirectSOFT),
     DECL(alGetSourcedvDirectSOFT),
     DECL(alSourcePlayAtTimeDirectSOFT),
     DECL(alSourcePlayAtTimevDirectSOFT),
+    DECL(alSourceStopAtTimeDirectSOFT),
+    DECL(alSourceStopAtTimevDirectSOFT),
+    DECL(alSourcePauseAtTimeDirectSOFT),
+    DECL(alSourcePauseAtTimevDirectSOFT),
+    DECL(alSourceRampGainAtTimeDirectSOFT),
+    DECL(alSourceRampGainAtTimevDirectSOFT),
 
     DECL(alEventControlDirectSOFT),
     DECL(alEventCallbackDirectSOFT),
+    DECL(alEventBatchCallbackDirectSOFT),
+    DECL(alPollEventsDirectSOFT),
 
     DECL(alDebugMessageCallbackDirectEXT),
     DECL(alDebugMessageInsertDirectEXT),
@@ -842,6 +861,10 @@ inline const EnumExport alcEnumerations[]{
 
     DECL(AL_EVENT_CALLBACK_FUNCTION_SOFT),
     DECL(AL_EVENT_CALLBACK_USER_PARAM_SOFT),
+    DECL(AL_EVENT_BATCH_CALLBACK_FUNCTION_SOFT),
+    DECL(AL_EVENT_BATCH_CALLBACK_USER_PARAM_SOFT),
+    DECL(AL_EVENT_POLLING_SOFT),
+    DECL(AL_EVENT_POLL_FD_SOFT),
     DECL(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT),
     DECL(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT),
     DECL(AL_EVENT_TYPE_DISCONNECTED_SOFT),
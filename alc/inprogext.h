@@ -55,6 +55,179 @@ void AL_APIENTRY alFlushMappedBufferDirectSOFT(ALCcontext *context, ALuint buffe
 #endif
 
 
+#ifndef ALC_SOFT_loopback_planar
+#define ALC_SOFT_loopback_planar
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESPLANARSOFT)(ALCdevice *device, ALCvoid **buffers, ALCsizei samples) ALC_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API void ALC_APIENTRY alcRenderSamplesPlanarSOFT(ALCdevice *device, ALCvoid **buffers, ALCsizei samples) ALC_API_NOEXCEPT;
+#endif
+#endif
+
+
+#ifndef ALC_SOFT_mix_block_size
+#define ALC_SOFT_mix_block_size
+#define ALC_MIX_BLOCK_SIZE_SOFT                  0x19EE
+#endif
+
+#ifndef ALC_SOFT_mixer_profile
+#define ALC_SOFT_mixer_profile
+#define ALC_MIXER_PROFILING_SOFT                 0x19EF
+#define ALC_MIXER_PROFILE_NUM_STAGES_SOFT        0x19F0
+/* Returns 5 values for each stage with alcGetInteger64vSOFT: the number of
+ * times the stage was timed, and the minimum, average, 99th percentile, and
+ * maximum time in nanoseconds. A stage is timed once in each mix update it
+ * runs in, except parameter updates and voice mixing, which are timed per
+ * context, and effects, which are timed per effect slot (or per slot level
+ * when using effect threads). The stages are, in order: parameter updates,
+ * voice mixing, effect processing, post-processing, limiter, distance
+ * compensation, dithering, output conversion, and the total mixing pass.
+ */
+#define ALC_MIXER_PROFILE_STATS_SOFT             0x19F1
+/* Returns 3 values for each of the current context's pools with
+ * alcGetInteger64vSOFT: the number of items in use, the most that have been
+ * in use at once, and the number of times the pool ran out with fixed pools.
+ * The pools are, in order: voice changes, source properties, effect slot
+ * properties, and context properties. The current context must be on the
+ * device.
+ */
+#define ALC_CONTEXT_POOL_STATS_SOFT              0x19FB
+#endif
+
+#ifndef AL_SOFT_mixer_load_events
+#define AL_SOFT_mixer_load_events
+/* Sent at most twice a second when the mixer missed a deadline, the device
+ * underran, or the mixing load was at least 80% of the time available. The
+ * object is the peak load as a percentage, and the param is the number of
+ * deadline misses and underruns since the last event.
+ */
+#define AL_EVENT_TYPE_MIXER_LOAD_SOFT            0x19F2
+/* Device queries for the running totals, with alcGetInteger64vSOFT. */
+#define ALC_MIXER_DEADLINE_MISSES_SOFT           0x19F3
+#define ALC_MIXER_UNDERRUNS_SOFT                 0x19F4
+#endif
+
+#ifndef AL_SOFT_pitch_shifter_quality
+#define AL_SOFT_pitch_shifter_quality
+/* Pitch shifter effect property. High uses a 1024-point STFT with 8x overlap,
+ * medium uses a 512-point STFT with 4x overlap, and low uses a time-domain
+ * shifter with cross-faded delay taps.
+ */
+#define AL_PITCH_SHIFTER_QUALITY_SOFT            0x19F5
+#define AL_PITCH_SHIFTER_QUALITY_HIGH_SOFT       0
+#define AL_PITCH_SHIFTER_QUALITY_MEDIUM_SOFT     1
+#define AL_PITCH_SHIFTER_QUALITY_LOW_SOFT        2
+#define AL_PITCH_SHIFTER_DEFAULT_QUALITY_SOFT    AL_PITCH_SHIFTER_QUALITY_HIGH_SOFT
+#endif
+
+#ifndef AL_SOFT_event_batch
+#define AL_SOFT_event_batch
+/* An alternative to the AL_SOFT_events callback, which gets the events the
+ * handler has ready in one call per wake-up, without a message. The fields
+ * match the ALEVENTPROCSOFT parameters. Both callbacks may be set, and each
+ * gets all enabled events.
+ */
+typedef struct ALeventSOFT {
+    ALenum type;
+    ALuint object;
+    ALuint param;
+} ALeventSOFT;
+#define AL_EVENT_BATCH_CALLBACK_FUNCTION_SOFT    0x19F6
+#define AL_EVENT_BATCH_CALLBACK_USER_PARAM_SOFT  0x19F7
+typedef void (AL_APIENTRY*ALEVENTBATCHPROCSOFT)(const ALeventSOFT *events, ALsizei count, void *userParam) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALEVENTBATCHCALLBACKSOFT)(ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALEVENTBATCHCALLBACKDIRECTSOFT)(ALCcontext *context, ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alEventBatchCallbackSOFT(ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT;
+void AL_APIENTRY alEventBatchCallbackDirectSOFT(ALCcontext *context, ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_source_schedule
+#define AL_SOFT_source_schedule
+/* Schedules changes to playing sources at the given device clock time (as
+ * with alSourcePlayAtTimeSOFT), to the sample. Scheduled starts are done with
+ * alSourcePlayAtTime[v]SOFT.
+ *
+ * alSourceStopAtTime[v]SOFT and alSourcePauseAtTime[v]SOFT stop or pause the
+ * sources at the given time. Sources that aren't playing are ignored. A
+ * source has one scheduled stop or pause at a time, the latest one replacing
+ * any earlier one, and pausing or restarting a source cancels it. A source
+ * paused this way reports AL_PAUSED once the mixer gets to the pause time.
+ *
+ * alSourceRampGainAtTime[v]SOFT moves an extra gain on playing or paused
+ * sources linearly to the given gain, from start_time to end_time. The gain
+ * stays once the ramp is done, until the source is restarted (it starts at
+ * 1). A new ramp replaces the one in progress, starting from the gain the
+ * mixer has reached when it gets the new ramp.
+ */
+typedef void (AL_APIENTRY*LPALSOURCESTOPATTIMESOFT)(ALuint source, ALint64SOFT stop_time) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCESTOPATTIMEVSOFT)(ALsizei n, const ALuint *sources, ALint64SOFT stop_time) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCEPAUSEATTIMESOFT)(ALuint source, ALint64SOFT pause_time) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCEPAUSEATTIMEVSOFT)(ALsizei n, const ALuint *sources, ALint64SOFT pause_time) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCERAMPGAINATTIMESOFT)(ALuint source, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCERAMPGAINATTIMEVSOFT)(ALsizei n, const ALuint *sources, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+void AL_APIENTRY alSourceStopAtTimeSOFT(ALuint source, ALint64SOFT stop_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceStopAtTimevSOFT(ALsizei n, const ALuint *sources, ALint64SOFT stop_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourcePauseAtTimeSOFT(ALuint source, ALint64SOFT pause_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourcePauseAtTimevSOFT(ALsizei n, const ALuint *sources, ALint64SOFT pause_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceRampGainAtTimeSOFT(ALuint source, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceRampGainAtTimevSOFT(ALsizei n, const ALuint *sources, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceStopAtTimeDirectSOFT(ALCcontext *context, ALuint source, ALint64SOFT stop_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceStopAtTimevDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALint64SOFT stop_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourcePauseAtTimeDirectSOFT(ALCcontext *context, ALuint source, ALint64SOFT pause_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourcePauseAtTimevDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALint64SOFT pause_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceRampGainAtTimeDirectSOFT(ALCcontext *context, ALuint source, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceRampGainAtTimevDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALfloat gain, ALint64SOFT start_time, ALint64SOFT end_time) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_source_states
+#define AL_SOFT_source_states
+/* Gets the state and AL_SAMPLE_OFFSET_LATENCY_SOFT-style offset (32.32 fixed-
+ * point samples) of each source, all read at the same device clock time.
+ * clocklatency receives that clock time followed by the output latency, in
+ * nanoseconds. Any of the output pointers may be NULL.
+ */
+typedef void (AL_APIENTRY*LPALGETSOURCESTATESSOFT)(ALsizei n, const ALuint *sources, ALenum *states, ALint64SOFT *offsets, ALint64SOFT *clocklatency) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETSOURCESTATESDIRECTSOFT)(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum *states, ALint64SOFT *offsets, ALint64SOFT *clocklatency) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alGetSourceStatesSOFT(ALsizei n, const ALuint *sources, ALenum *states, ALint64SOFT *offsets, ALint64SOFT *clocklatency) AL_API_NOEXCEPT;
+void AL_APIENTRY alGetSourceStatesDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum *states, ALint64SOFT *offsets, ALint64SOFT *clocklatency) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_event_poll
+#define AL_SOFT_event_poll
+/* While enabled with alEnable, events are not sent to the event callbacks.
+ * They're instead read with alPollEventsSOFT, which doesn't block and returns
+ * the number of events written. AL_EVENT_POLL_FD_SOFT, queried with
+ * alGetInteger, is a file descriptor that's readable while events are
+ * waiting, or -1 if the system doesn't have one.
+ */
+#define AL_EVENT_POLLING_SOFT                    0x19F8
+#define AL_EVENT_POLL_FD_SOFT                    0x19F9
+typedef ALsizei (AL_APIENTRY*LPALPOLLEVENTSSOFT)(ALeventSOFT *events, ALsizei count) AL_API_NOEXCEPT17;
+typedef ALsizei (AL_APIENTRY*LPALPOLLEVENTSDIRECTSOFT)(ALCcontext *context, ALeventSOFT *events, ALsizei count) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API ALsizei AL_APIENTRY alPollEventsSOFT(ALeventSOFT *events, ALsizei count) AL_API_NOEXCEPT;
+ALsizei AL_APIENTRY alPollEventsDirectSOFT(ALCcontext *context, ALeventSOFT *events, ALsizei count) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_device_bus
+#define AL_SOFT_device_bus
+/* Effect slot property. Slots on the same device set to the same bus (1 to 4,
+ * or 0 for none) share one mix across contexts. The first slot put on a bus
+ * owns it, and sends to any slot on the bus go to the owner's effect, which
+ * is processed once per update after all contexts have mixed. Other slots on
+ * the bus don't process their own effect while it has an owner. Slots on a
+ * bus can't target, or be targeted by, other effect slots.
+ */
+#define AL_EFFECTSLOT_DEVICE_BUS_SOFT            0x19FA
+#endif
+
+
 #ifndef AL_EXT_32bit_formats
 #define AL_EXT_32bit_formats
 #define AL_FORMAT_MONO_I32                       0x19DB
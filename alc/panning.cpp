@@ -1258,4 +1258,15 @@ void aluInitEffectPanning(EffectSlot *slot, ALCcontext *context)
         [](const uint8_t &acn) noexcept -> BFChannelConfig { return BFChannelConfig{1.0f, acn}; });
     std::fill(iter, slot->Wet.AmbiMap.end(), BFChannelConfig{});
     slot->Wet.Buffer = slot->mWetBuffer;
+    slot->mHasInput = true;
+
+    /* The private output buffer needs to hold any output target the effect
+     * may use. That includes another slot's wet buffer, which can have more
+     * channels than the dry buffer with a 2D output layout.
+     */
+    if(device->mEffectThreads)
+        slot->mOutBuffer.resize(std::max({device->Dry.Buffer.size(),
+            device->RealOut.Buffer.size(), count}));
+    else
+        decltype(slot->mOutBuffer){}.swap(slot->mOutBuffer);
 }
@@ -17,6 +17,7 @@ enum class AsyncEnableBits : std::uint8_t {
     SourceState,
     BufferCompleted,
     Disconnected,
+    MixerLoad,
     Count
 };
 
@@ -44,6 +45,12 @@ struct AsyncDisconnectEvent {
     std::string msg;
 };
 
+struct AsyncMixerLoadEvent {
+    uint mPeakLoad; /* Percentage of the time budget. */
+    uint mDeadlineMisses;
+    uint mUnderruns;
+};
+
 struct AsyncEffectReleaseEvent {
     EffectState *mEffectState;
 };
@@ -52,6 +59,7 @@ using AsyncEvent = std::variant<AsyncKillThread,
         AsyncSourceStateEvent,
         AsyncBufferCompleteEvent,
         AsyncEffectReleaseEvent,
+        AsyncMixerLoadEvent,
         AsyncDisconnectEvent>;
 
 template<typename T, typename ...Args>
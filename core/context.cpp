@@ -2,21 +2,32 @@
 #include "config.h"
 
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <system_error>
+#include <tuple>
 #include <utility>
 
+#include "alspan.h"
 #include "async_event.h"
 #include "context.h"
 #include "device.h"
 #include "effectslot.h"
 #include "logging.h"
+#include "opthelpers.h"
 #include "ringbuffer.h"
 #include "voice.h"
 #include "voice_change.h"
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 
 #ifdef __cpp_lib_atomic_is_always_lock_free
 static_assert(std::atomic<ContextBase::AsyncEventBitset>::is_always_lock_free, "atomic<bitset> isn't lock-free");
@@ -27,6 +38,29 @@ ContextBase::ContextBase(DeviceBase *device) : mDevice{device}
 
 ContextBase::~ContextBase()
 {
+    auto report_usage = [](const char *name, const PoolUsage &usage, const size_t total)
+    {
+        const size_t exhausted{usage.mExhausted.load(std::memory_order_relaxed)};
+        if(exhausted > 0)
+            WARN("%s pool ran out %zu time%s (peak %zu in use, %zu allocated)\n", name,
+                exhausted, (exhausted==1)?"":"s", usage.mPeak.load(std::memory_order_relaxed),
+                total);
+        else
+            TRACE("%s pool: peak %zu in use, %zu allocated\n", name,
+                usage.mPeak.load(std::memory_order_relaxed), total);
+    };
+    report_usage("Voice change", mVoiceChangeUsage, numVoiceChanges());
+    report_usage("Voice property", mVoicePropsUsage, numVoiceProps());
+    report_usage("Effect slot property", mEffectSlotPropsUsage,
+        mEffectSlotPropClusters.size()
+        * std::tuple_size_v<EffectSlotPropsCluster::element_type>);
+    report_usage("Context property", mContextPropsUsage,
+        mContextPropClusters.size() * std::tuple_size_v<ContextPropsCluster::element_type>);
+
+#ifdef __linux__
+    if(mEventFd >= 0)
+        close(mEventFd);
+#endif
     mActiveAuxSlots.store(nullptr, std::memory_order_relaxed);
     mVoices.store(nullptr, std::memory_order_relaxed);
 
@@ -88,6 +122,67 @@ void ContextBase::allocVoiceProps()
         std::memory_order_acq_rel, std::memory_order_acquire) == false);
 }
 
+void ContextBase::reserveProps()
+{
+    static constexpr size_t vpropsize{std::tuple_size_v<VoicePropsCluster::element_type>};
+    static constexpr size_t spropsize{std::tuple_size_v<EffectSlotPropsCluster::element_type>};
+
+    while(mVoicePropClusters.size()*vpropsize < mVoicePropsReserve)
+        allocVoiceProps();
+    while(mEffectSlotPropClusters.size()*spropsize < mEffectSlotPropsReserve)
+        allocEffectSlotProps();
+    if(mContextPropClusters.empty())
+        allocContextProps();
+}
+
+auto ContextBase::numVoiceChanges() const noexcept -> size_t
+{
+    return mVoiceChangeClusters.size()
+        * std::tuple_size_v<VoiceChangeCluster::element_type>;
+}
+
+auto ContextBase::numVoiceProps() const noexcept -> size_t
+{ return mVoicePropClusters.size() * std::tuple_size_v<VoicePropsCluster::element_type>; }
+
+void ContextBase::initEventFd() noexcept
+{
+#ifdef __linux__
+    if(mEventFd >= 0)
+        return;
+    mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(mEventFd < 0)
+        WARN("Failed to create event fd: %s\n", std::generic_category().message(errno).c_str());
+#endif
+}
+
+void ContextBase::clearEventFd() noexcept
+{
+#ifdef __linux__
+    if(mEventFd >= 0)
+    {
+        uint64_t count{};
+        std::ignore = read(mEventFd, &count, sizeof(count));
+    }
+#endif
+}
+
+void ContextBase::signalEvents() noexcept
+{
+    if(!mEventPolling.load(std::memory_order_acquire))
+    {
+        mEventSem.post();
+        return;
+    }
+#ifdef __linux__
+    if(mEventFd >= 0)
+    {
+        const uint64_t count{1};
+        std::ignore = write(mEventFd, &count, sizeof(count));
+    }
+#endif
+}
+
+
 void ContextBase::allocVoices(size_t addcount)
 {
     static constexpr size_t clustersize{std::tuple_size_v<VoiceCluster::element_type>};
@@ -103,6 +198,7 @@ void ContextBase::allocVoices(size_t addcount)
 
     if(addcount >= std::numeric_limits<int>::max()/clustersize - mVoiceClusters.size())
         throw std::runtime_error{"Allocating too many voices"};
+    const size_t oldcount{mVoiceClusters.size() * clustersize};
     const size_t totalcount{(mVoiceClusters.size()+addcount) * clustersize};
     TRACE("Increasing allocated voices to %zu\n", totalcount);
 
@@ -112,14 +208,135 @@ void ContextBase::allocVoices(size_t addcount)
         --addcount;
     }
 
-    auto newarray = VoiceArray::Create(totalcount);
-    auto voice_iter = newarray->begin();
+    /* The mixer builds its list of voices to process once it sees the new
+     * array.
+     */
+    auto newarray = std::make_unique<VoiceArray>(totalcount);
+    auto voice_iter = newarray->mAllVoices.begin();
     for(VoiceCluster &cluster : mVoiceClusters)
         voice_iter = std::transform(cluster->begin(), cluster->end(), voice_iter,
             [](Voice &voice) noexcept -> Voice* { return &voice; });
 
+    /* If all the clusters are new, any listed voices are gone. */
+    if(oldcount == 0)
+    {
+        mFreeVoices.store(nullptr, std::memory_order_relaxed);
+        mFreeVoiceCount.store(0u, std::memory_order_relaxed);
+    }
+
     if(auto oldvoices = mVoices.exchange(std::move(newarray), std::memory_order_acq_rel))
         std::ignore = mDevice->waitForMix();
+
+    /* All voices are active, so the mixer only sees the new ones once the new
+     * array is in place. Add them in reverse so the lowest ones get used
+     * first, keeping the mixing order the same as the array order.
+     */
+    const auto voices = mVoices.load(std::memory_order_relaxed)->mAllVoices;
+    for(size_t i{voices.size()};i > oldcount;)
+    {
+        --i;
+        voices[i]->mVoiceIdx = static_cast<uint>(i);
+        addFreeVoice(voices[i]);
+    }
+    mActiveVoiceCount.store(voices.size(), std::memory_order_release);
+}
+
+ContextBase::VoiceArray::VoiceArray(size_t count)
+    : mStorage{std::make_unique<Voice*[]>(count*2)}
+{
+    const auto storage = al::span{mStorage.get(), count*2};
+    mAllVoices = storage.first(count);
+    mMixList = storage.subspan(count);
+}
+
+auto ContextBase::getMixVoices() noexcept -> al::span<Voice*>
+{
+    VoiceArray &voicearray = *mVoices.load(std::memory_order_acquire);
+    if(!voicearray.mMixListBuilt) UNLIKELY
+    {
+        /* Keep the array order, as the mixer would've when going through all
+         * the voices. Voices that are dropped because they were missed when
+         * stopping get returned to the free list.
+         */
+        voicearray.mMixCount = 0;
+        for(Voice *voice : voicearray.mAllVoices)
+        {
+            const bool active{voice->mSourceID.load(std::memory_order_relaxed) != 0u
+                || voice->mPlayState.load(std::memory_order_acquire) != Voice::Stopped};
+            if(active)
+                voicearray.mMixList[voicearray.mMixCount++] = voice;
+            else if(voice->mInMixList)
+                addFreeVoice(voice);
+            voice->mInMixList = active;
+        }
+        voicearray.mMixListBuilt = true;
+    }
+    return voicearray.mMixList.first(voicearray.mMixCount);
+}
+
+void ContextBase::addMixVoice(Voice *voice) noexcept
+{
+    if(voice->mInMixList)
+        return;
+
+    /* If the array was replaced (or the voice is newer than the array), the
+     * voice will be found when the list gets built for the new array.
+     */
+    VoiceArray &voicearray = *mVoices.load(std::memory_order_acquire);
+    if(voice->mVoiceIdx >= voicearray.mAllVoices.size() || !voicearray.mMixListBuilt)
+        return;
+
+    voicearray.mMixList[voicearray.mMixCount++] = voice;
+    voice->mInMixList = true;
+}
+
+void ContextBase::addFreeVoice(Voice *voice) noexcept
+{
+    if(voice->mPlayState.load(std::memory_order_acquire) != Voice::Stopped
+        || voice->mSourceID.load(std::memory_order_relaxed) != 0u
+        || voice->mPendingChange.load(std::memory_order_acquire))
+        return;
+    if(voice->mInFreeList.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    mFreeVoiceCount.fetch_add(1u, std::memory_order_relaxed);
+    Voice *oldhead{mFreeVoices.load(std::memory_order_relaxed)};
+    do {
+        voice->mNextFree.store(oldhead, std::memory_order_relaxed);
+    } while(!mFreeVoices.compare_exchange_weak(oldhead, voice, std::memory_order_acq_rel,
+        std::memory_order_relaxed));
+}
+
+Voice *ContextBase::getFreeVoice()
+{
+    while(true)
+    {
+        /* Only one thread pops at a time and a listed voice can't be pushed
+         * again, so the head's next link is stable while it's listed.
+         */
+        Voice *voice{mFreeVoices.load(std::memory_order_acquire)};
+        while(voice && !mFreeVoices.compare_exchange_weak(voice,
+            voice->mNextFree.load(std::memory_order_relaxed), std::memory_order_acq_rel,
+            std::memory_order_acquire))
+        {
+        }
+        if(!voice)
+        {
+            allocVoices(1);
+            continue;
+        }
+        mFreeVoiceCount.fetch_sub(1u, std::memory_order_relaxed);
+
+        /* Unlisting syncs with the mixer's listing, so an entry that has gone
+         * stale will show as such here, and may be listed again once it's
+         * free.
+         */
+        voice->mInFreeList.exchange(false, std::memory_order_acq_rel);
+        if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
+            && voice->mSourceID.load(std::memory_order_relaxed) == 0u
+            && voice->mPendingChange.load(std::memory_order_acquire) == false)
+            return voice;
+    }
 }
 
 
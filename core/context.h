@@ -29,6 +29,33 @@ struct VoicePropsItem;
 
 inline constexpr float SpeedOfSoundMetersPerSec{343.3f};
 
+/* Usage counts for one of a context's pools, to help size its reservation.
+ * Items count as in use from when the API takes them until they're returned.
+ */
+struct PoolUsage {
+    std::atomic<size_t> mInUse{0u};
+    std::atomic<size_t> mPeak{0u};
+    /* The number of times a fixed pool ran out, either growing anyway or
+     * failing the call.
+     */
+    std::atomic<size_t> mExhausted{0u};
+
+    void take() noexcept
+    {
+        const size_t inuse{mInUse.fetch_add(1u, std::memory_order_relaxed) + 1u};
+        size_t peak{mPeak.load(std::memory_order_relaxed)};
+        while(inuse > peak
+            && !mPeak.compare_exchange_weak(peak, inuse, std::memory_order_relaxed))
+        { }
+    }
+    /* Should be called after the items are back in the pool, so a count read
+     * with inUse() never has more free than are really available.
+     */
+    void give(size_t count=1u) noexcept { mInUse.fetch_sub(count, std::memory_order_release); }
+    [[nodiscard]]
+    auto inUse() const noexcept -> size_t { return mInUse.load(std::memory_order_acquire); }
+};
+
 inline constexpr float AirAbsorbGainHF{0.99426f}; /* -0.05dB */
 
 enum class DistanceModel : unsigned char {
@@ -105,29 +132,102 @@ struct ContextBase {
     VoiceChange *mVoiceChangeTail{};
     std::atomic<VoiceChange*> mCurrentVoiceChange{};
 
+    /* The number of voice changes and property containers to allocate up
+     * front. With fixed pools, these aren't expected to grow afterward; a
+     * property update reuses the object's pending container when the pool is
+     * empty, and voice changes fail instead.
+     *
+     * The one exception is a property update for an object without a pending
+     * container, when the rest are all pending for other objects. The update
+     * can't be dropped, so the pool grows. Since each object holds at most one
+     * pending container, that's bounded by the number of objects. It's counted
+     * as the pool running out, which ALC_CONTEXT_POOL_STATS_SOFT reports.
+     */
+    size_t mVoiceChangeReserve{128u};
+    size_t mVoicePropsReserve{32u};
+    size_t mEffectSlotPropsReserve{4u};
+    bool mFixedPools{false};
+
+    PoolUsage mVoiceChangeUsage;
+    PoolUsage mVoicePropsUsage;
+    PoolUsage mEffectSlotPropsUsage;
+    PoolUsage mContextPropsUsage;
+
     void allocVoiceChanges();
     void allocVoiceProps();
     void allocEffectSlotProps();
     void allocContextProps();
 
+    /* Allocates property containers up to the reserved sizes. */
+    void reserveProps();
+    [[nodiscard]] auto numVoiceChanges() const noexcept -> size_t;
+    [[nodiscard]] auto numVoiceProps() const noexcept -> size_t;
+
     ContextParams mParams;
 
-    using VoiceArray = al::FlexArray<Voice*>;
+    /* A pointer to each allocated voice, along with the mixer's list of voices
+     * to process. Both are allocated together, and the mixer list has room for
+     * every voice. The API thread fills in the voices before publishing the
+     * array, after which it's read-only to the API. The mixer list starts out
+     * unbuilt, and once the mixer sees the array it builds the list from the
+     * voices and keeps it up to date; nothing else touches the list or its
+     * count.
+     */
+    struct VoiceArray {
+        al::span<Voice*> mAllVoices;
+        al::span<Voice*> mMixList;
+        size_t mMixCount{0u};
+        bool mMixListBuilt{false};
+
+        std::unique_ptr<Voice*[]> mStorage;
+
+        explicit VoiceArray(size_t count);
+    };
     al::atomic_unique_ptr<VoiceArray> mVoices{};
     std::atomic<size_t> mActiveVoiceCount{};
 
+    /* Lock-free list of voices that are stopped, with no source and no
+     * pending change. The mixer adds voices as they finish stopping, and the
+     * API pops them to play sources (only while holding the source lock, so
+     * there's never more than one thread popping). An entry can go stale if
+     * its voice was reused before the mixer noticed, so popped voices are
+     * checked again.
+     */
+    std::atomic<Voice*> mFreeVoices{nullptr};
+    std::atomic<size_t> mFreeVoiceCount{0u};
+
+    /* Adds newly allocated voices to the free list. */
     void allocVoices(size_t addcount);
+    /* Adds the voice to the free list if it's free and not already listed. */
+    void addFreeVoice(Voice *voice) noexcept;
+    /* Pops a free voice, allocating more if none are left. */
+    Voice *getFreeVoice();
     [[nodiscard]] auto getVoicesSpan() const noexcept -> al::span<Voice*>
     {
-        return {mVoices.load(std::memory_order_relaxed)->data(),
-            mActiveVoiceCount.load(std::memory_order_relaxed)};
+        return mVoices.load(std::memory_order_relaxed)->mAllVoices.first(
+            mActiveVoiceCount.load(std::memory_order_relaxed));
     }
     [[nodiscard]] auto getVoicesSpanAcquired() const noexcept -> al::span<Voice*>
     {
-        return {mVoices.load(std::memory_order_acquire)->data(),
-            mActiveVoiceCount.load(std::memory_order_acquire)};
+        return mVoices.load(std::memory_order_acquire)->mAllVoices.first(
+            mActiveVoiceCount.load(std::memory_order_acquire));
     }
 
+    /* Gets the mixer's list of voices that have a source or are still
+     * stopping, building it from all voices if the array was replaced. Only
+     * the mixer may call this.
+     */
+    auto getMixVoices() noexcept -> al::span<Voice*>;
+    /* Adds the voice to the mixer's list, if it isn't already. Only the mixer
+     * may call this.
+     */
+    void addMixVoice(Voice *voice) noexcept;
+    /* Shortens the mixer's list to its first count voices, after the mixer
+     * removed the finished ones. Only the mixer may call this.
+     */
+    void trimMixVoices(size_t count) noexcept
+    { mVoices.load(std::memory_order_relaxed)->mMixCount = count; }
+
 
     using EffectSlotArray = al::FlexArray<EffectSlot*>;
     /* This array is split in half. The front half is the list of activated
@@ -142,6 +242,19 @@ struct ContextBase {
     using AsyncEventBitset = std::bitset<al::to_underlying(AsyncEnableBits::Count)>;
     std::atomic<AsyncEventBitset> mEnabledEvts{0u};
 
+    /* While set, the app reads the async events instead of the event thread,
+     * and is signaled through mEventFd (if the system has one).
+     */
+    std::atomic<bool> mEventPolling{false};
+    int mEventFd{-1};
+
+    /* Creates mEventFd, if it isn't already. */
+    void initEventFd() noexcept;
+    /* Clears the signal on mEventFd. */
+    void clearEventFd() noexcept;
+    /* Wakes whichever of the event thread or the app reads the async events. */
+    void signalEvents() noexcept;
+
     /* Asynchronous voice change actions are processed as a linked list of
      * VoiceChange objects by the mixer, which is atomically appended to.
      * However, to avoid allocating each object individually, they're allocated
@@ -4,6 +4,7 @@
 #include "bformatdec.h"
 #include "bs2b.h"
 #include "device.h"
+#include "effect_threads.h"
 #include "front_stablizer.h"
 #include "hrtf.h"
 #include "mastering.h"
@@ -20,6 +20,7 @@
 #include "flexarray.h"
 #include "intrusive_ptr.h"
 #include "mixer/hrtfdefs.h"
+#include "mixprofile.h"
 #include "opthelpers.h"
 #include "resampler_limits.h"
 #include "uhjfilter.h"
@@ -32,6 +33,8 @@ struct bs2b;
 class Compressor;
 struct ContextBase;
 struct DirectHrtfState;
+struct EffectSlot;
+class EffectThreadPool;
 struct HrtfStore;
 
 using uint = unsigned int;
@@ -44,6 +47,16 @@ inline constexpr std::size_t DefaultOutputRate{48000};
 inline constexpr std::size_t DefaultUpdateSize{960}; /* 20ms */
 inline constexpr std::size_t DefaultNumUpdates{3};
 
+/* Limits for the number of samples mixed between property updates. Blocks
+ * larger than BufferLineSize are mixed in multiple passes.
+ */
+inline constexpr std::size_t MinMixBlockSize{64};
+inline constexpr std::size_t MaxMixBlockSize{BufferLineSize*4};
+inline constexpr std::size_t DefaultMixBlockSize{BufferLineSize};
+
+/* The number of device-level aux buses effect slots can share. */
+inline constexpr std::size_t MaxDeviceBuses{4};
+
 
 enum class DeviceType : std::uint8_t {
     Playback,
@@ -186,6 +199,10 @@ struct SIMDALIGN DeviceBase {
     uint Frequency{};
     uint UpdateSize{};
     uint BufferSize{};
+    /* The maximum number of samples mixed between property updates, between
+     * MinMixBlockSize and MaxMixBlockSize.
+     */
+    uint mMixBlockSize{DefaultMixBlockSize};
 
     DevFmtChannels FmtChans{};
     DevFmtType FmtType{};
@@ -210,6 +227,11 @@ struct SIMDALIGN DeviceBase {
     /* Rendering mode. */
     RenderMode mRenderMode{RenderMode::Normal};
 
+    /* Use IIR all-pass filters for the frequency shifter effect's Hilbert
+     * transform, instead of the FFT-based one.
+     */
+    bool mFshifterIIR{false};
+
     /* The average speaker distance as determined by the ambdec configuration,
      * HRTF data set, or the NFC-HOA reference delay. Only used for NFC.
      */
@@ -277,6 +299,32 @@ struct SIMDALIGN DeviceBase {
     float DitherDepth{0.0f};
     uint DitherSeed{0u};
 
+    /* Per-stage mixer timing, only allocated when profiling is enabled. */
+    std::unique_ptr<MixerProfile> mProfile;
+
+    /* Worker threads for processing independent effect slots concurrently,
+     * only allocated when enabled with the effect-threads config option.
+     */
+    std::unique_ptr<EffectThreadPool> mEffectThreads;
+
+    /* Running totals of mixing passes that took longer than the time they
+     * rendered or were started late by the backend, and of underruns reported
+     * by the backend.
+     */
+    std::atomic<std::uint64_t> mDeadlineMisses{0u};
+    std::atomic<std::uint64_t> mUnderruns{0u};
+
+    /* Mixer load accumulated since the last load report, only accessed by the
+     * mixer thread.
+     */
+    struct MixerLoadState {
+        uint mSamples{0u};
+        float mPeakLoad{0.0f};
+        uint mDeadlineMisses{0u};
+        std::uint64_t mLastUnderruns{0u};
+    };
+    MixerLoadState mLoadState;
+
     /* Running count of the mixer invocations, in 31.1 fixed point. This
      * actually increments *twice* when mixing, first at the start and then at
      * the end, so the bottom bit indicates if the device is currently mixing
@@ -287,6 +335,14 @@ struct SIMDALIGN DeviceBase {
     // Contexts created on this device
     al::atomic_unique_ptr<al::FlexArray<ContextBase*>> mContexts;
 
+    /* The effect slot owning each device bus, which takes the input sent to
+     * any slot on that bus from every context, and is processed once after
+     * all contexts have mixed. Set by the owning context, while the mixer
+     * works from the copy it takes at the start of each update.
+     */
+    std::array<std::atomic<EffectSlot*>,MaxDeviceBuses> mBusSlots{};
+    std::array<EffectSlot*,MaxDeviceBuses> mMixBusSlots{};
+
 
     DeviceBase(DeviceType type);
     DeviceBase(const DeviceBase&) = delete;
@@ -353,6 +409,19 @@ struct SIMDALIGN DeviceBase {
     void renderSamples(const al::span<void*> outBuffers, const uint numSamples);
     void renderSamples(void *outBuffer, const uint numSamples, const std::size_t frameStep);
 
+    /** Called by backends when the output device ran out of samples to play. */
+    void noteUnderrun() noexcept { mUnderruns.fetch_add(1u, std::memory_order_relaxed); }
+    /**
+     * Called by backends from the mixer thread when it woke up too late to mix
+     * on time.
+     */
+    void noteDeadlineMiss() noexcept
+    {
+        mDeadlineMisses.store(mDeadlineMisses.load(std::memory_order_relaxed)+1,
+            std::memory_order_relaxed);
+        ++mLoadState.mDeadlineMisses;
+    }
+
     /* Caller must lock the device state, and the mixer must not be running. */
 #ifdef __MINGW32__
     [[gnu::format(__MINGW_PRINTF_FORMAT,2,3)]]
@@ -369,7 +438,12 @@ struct SIMDALIGN DeviceBase {
     { return RealOut.ChannelIndex[chan]; }
 
 private:
-    uint renderSamples(const uint numSamples);
+    template<bool Profiled>
+    uint renderSamples(const uint numSamples, const bool newBlock);
+    template<bool Profiled, typename F>
+    void renderLoop(const uint numSamples, F&& writer);
+
+    void updateMixerLoad(const std::chrono::nanoseconds renderTime, const uint numSamples);
 };
 
 /* Must be less than 15 characters (16 including terminating null) for
@@ -0,0 +1,88 @@
+
+#include "config.h"
+
+#include "effect_threads.h"
+
+#include <algorithm>
+
+#include "althrd_setname.h"
+#include "fpu_ctrl.h"
+#include "helpers.h"
+
+
+EffectThreadPool::EffectThreadPool(const std::size_t numthreads)
+{
+    mThreads.reserve(numthreads);
+    try {
+        for(std::size_t i{0};i < numthreads;++i)
+            mThreads.emplace_back(&EffectThreadPool::workerProc, this);
+    }
+    catch(...) {
+        mQuit.store(true, std::memory_order_release);
+        for(std::size_t i{0};i < mThreads.size();++i)
+            mWorkSem.post();
+        for(auto &thrd : mThreads)
+            thrd.join();
+        throw;
+    }
+}
+
+EffectThreadPool::~EffectThreadPool()
+{
+    mQuit.store(true, std::memory_order_release);
+    for(std::size_t i{0};i < mThreads.size();++i)
+        mWorkSem.post();
+    for(auto &thrd : mThreads)
+        thrd.join();
+}
+
+
+void EffectThreadPool::doJobs() noexcept
+{
+    std::size_t idx{mNextJob.fetch_add(1, std::memory_order_relaxed)};
+    while(idx < mJobCount)
+    {
+        mFunc(mUserPtr, idx);
+        idx = mNextJob.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EffectThreadPool::workerProc() noexcept
+{
+    SetRTPriority();
+    althrd_setname("alsoft-effects");
+
+    /* Effects expect the same FPU state as the mixer. */
+    FPUCtl mixer_mode{};
+    while(true)
+    {
+        mWorkSem.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        doJobs();
+        if(mWorkersDone.fetch_add(1, std::memory_order_acq_rel)+1 == mWorkersWoken)
+            mDoneSem.post();
+    }
+}
+
+void EffectThreadPool::execute(const std::size_t count, JobFunc func, void *userptr) noexcept
+{
+    mFunc = func;
+    mUserPtr = userptr;
+    mJobCount = count;
+    mNextJob.store(0, std::memory_order_relaxed);
+
+    /* Only wake as many workers as there are jobs left for them. Every woken
+     * worker must check in before returning, so none are left looking at the
+     * job state when the next run sets it up.
+     */
+    mWorkersWoken = std::min(mThreads.size(), count ? count-1 : 0);
+    mWorkersDone.store(0, std::memory_order_relaxed);
+    for(std::size_t i{0};i < mWorkersWoken;++i)
+        mWorkSem.post();
+
+    doJobs();
+    if(mWorkersWoken > 0)
+        mDoneSem.wait();
+}
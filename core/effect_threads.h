@@ -0,0 +1,67 @@
+#ifndef CORE_EFFECT_THREADS_H
+#define CORE_EFFECT_THREADS_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "alsem.h"
+
+
+/* A small pool of worker threads for running independent effect slots
+ * concurrently. Only the mixer thread may call run(), which also does a share
+ * of the jobs itself and returns once they're all done. Workers are woken per
+ * run and sleep between them, so an idle pool costs nothing.
+ */
+class EffectThreadPool {
+    using JobFunc = void(*)(void *userptr, std::size_t idx);
+
+    std::vector<std::thread> mThreads;
+
+    JobFunc mFunc{nullptr};
+    void *mUserPtr{nullptr};
+    std::size_t mJobCount{0};
+    std::atomic<std::size_t> mNextJob{0};
+
+    /* The number of workers woken for the current run, and the number that
+     * have finished with it. The last to finish signals mDoneSem.
+     */
+    std::size_t mWorkersWoken{0};
+    std::atomic<std::size_t> mWorkersDone{0};
+
+    al::semaphore mWorkSem;
+    al::semaphore mDoneSem;
+    std::atomic<bool> mQuit{false};
+
+    void doJobs() noexcept;
+    void workerProc() noexcept;
+
+    void execute(const std::size_t count, JobFunc func, void *userptr) noexcept;
+
+public:
+    /* Creates the given number of worker threads. Throws if a thread can't be
+     * started.
+     */
+    explicit EffectThreadPool(const std::size_t numthreads);
+    EffectThreadPool(const EffectThreadPool&) = delete;
+    ~EffectThreadPool();
+
+    EffectThreadPool& operator=(const EffectThreadPool&) = delete;
+
+    [[nodiscard]] auto numThreads() const noexcept -> std::size_t { return mThreads.size(); }
+
+    /* Calls func(idx) for each idx in [0, count), spread across the workers
+     * and the calling thread, in no particular order.
+     */
+    template<typename F>
+    void run(const std::size_t count, F&& func) noexcept
+    {
+        using FuncType = std::remove_reference_t<F>;
+        execute(count, [](void *userptr, std::size_t idx)
+            { (*static_cast<FuncType*>(userptr))(idx); }, &func);
+    }
+};
+
+#endif /* CORE_EFFECT_THREADS_H */
@@ -1,8 +1,11 @@
 #ifndef CORE_EFFECTS_BASE_H
 #define CORE_EFFECTS_BASE_H
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <variant>
 
 #include "alspan.h"
@@ -17,6 +20,8 @@ struct EffectSlot;
 struct MixParams;
 struct RealMixParams;
 
+using uint = unsigned int;
+
 
 /** Target gain for the reverb decay feedback reaching the decay time. */
 inline constexpr float ReverbDecayGain{0.001f}; /* -60 dB */
@@ -47,6 +52,12 @@ enum class ModulatorWaveform {
     Square
 };
 
+enum class PshifterQuality {
+    High,
+    Medium,
+    Low
+};
+
 enum class VMorpherPhenome {
     A, E, I, O, U,
     AA, AE, AH, AO, EH, ER, IH, IY, UH, UW,
@@ -151,6 +162,7 @@ struct ModulatorProps {
 struct PshifterProps {
     int CoarseTune;
     int FineTune;
+    PshifterQuality Quality;
 };
 
 struct VmorpherProps {
@@ -195,7 +207,15 @@ struct EffectTarget {
 };
 
 struct SIMDALIGN EffectState : public al::intrusive_ref<EffectState> {
+    /* Largest possible tail length, meaning the effect is never bypassed. */
+    static constexpr uint InfiniteTail{std::numeric_limits<uint>::max()};
+
     al::span<FloatBufferLine> mOutTarget;
+    /* Number of samples the effect can keep producing output after its input
+     * goes silent. Set by deviceUpdate() or update(), and used to skip
+     * processing idle slots.
+     */
+    uint mTailLength{InfiniteTail};
 
 
     virtual ~EffectState() = default;
@@ -207,6 +227,18 @@ struct SIMDALIGN EffectState : public al::intrusive_ref<EffectState> {
         const al::span<FloatBufferLine> samplesOut) = 0;
 };
 
+/* Calculates the tail length of a feedback loop that repeats every period
+ * samples with the given gain, until it falls below -120dB.
+ */
+inline uint CalcFeedbackTail(const uint period, const float feedback) noexcept
+{
+    const float fbgain{std::abs(feedback)};
+    if(!(fbgain < 0.99f))
+        return EffectState::InfiniteTail;
+    const double repeats{(fbgain > 0.0f) ? std::ceil(std::log(1e-6) / std::log(fbgain)) : 0.0};
+    return static_cast<uint>(std::min((repeats+1.0) * period, double{EffectState::InfiniteTail}));
+}
+
 
 struct EffectStateFactory {
     EffectStateFactory() = default;
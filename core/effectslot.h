@@ -37,6 +37,7 @@ struct EffectSlotProps {
     float Gain;
     bool  AuxSendAuto;
     EffectSlot *Target;
+    uint DeviceBus;
 
     EffectSlotType Type;
     EffectProps Props;
@@ -62,6 +63,8 @@ struct EffectSlot {
     float Gain{1.0f};
     bool  AuxSendAuto{true};
     EffectSlot *Target{nullptr};
+    /* The device bus this slot is on (1-based), or 0 for none. */
+    uint DeviceBus{0};
 
     EffectSlotType EffectType{EffectSlotType::None};
     EffectProps mEffectProps{};
@@ -77,6 +80,27 @@ struct EffectSlot {
     /* Mixing buffer used by the Wet mix. */
     al::vector<FloatBufferLine,16> mWetBuffer;
 
+    /* Set when a voice or another slot mixes into the wet buffer during an
+     * update, so the buffer needs clearing before the next one. When input
+     * stops, the effect keeps processing silence for its tail length before
+     * being skipped altogether.
+     */
+    bool mHasInput{true};
+    uint mSilentSamples{0};
+
+    /* Set for slots whose input goes to a device bus, either as the bus owner
+     * or by sending to it, which the context skips when processing effects.
+     */
+    bool mOnDeviceBus{false};
+
+    /* Used when processing effects on multiple threads. Slots are grouped by
+     * their distance from the main output, and each slot in a group renders
+     * to its own output buffer, which is then mixed to its target in order.
+     */
+    uint mGraphLevel{0};
+    bool mProcessing{false};
+    al::vector<FloatBufferLine,16> mOutBuffer;
+
 
     static std::unique_ptr<EffectSlotArray> CreatePtrArray(size_t count);
 };
@@ -0,0 +1,158 @@
+
+#include "config.h"
+
+#include "lfo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+#include "alnumbers.h"
+
+
+namespace {
+
+/* Scales a phase, as a signed value, to -1...+1 (where -1 and +1 correspond
+ * to -pi and +pi).
+ */
+constexpr float PhaseScale{1.0f / 2147483648.0f};
+
+inline auto phase_to_signed(uint32_t phase) noexcept -> float
+{ return static_cast<float>(static_cast<int32_t>(phase)) * PhaseScale; }
+
+/* Coefficients to approximate sin(pi*x) for x in [0, 0.5], using a 9th order
+ * Taylor series. The error is less than 4e-6, at the end of the range.
+ */
+constexpr double Pi{al::numbers::pi};
+constexpr auto SinC1 = static_cast<float>(Pi);
+constexpr auto SinC3 = static_cast<float>(-Pi*Pi*Pi / 6.0);
+constexpr auto SinC5 = static_cast<float>(Pi*Pi*Pi*Pi*Pi / 120.0);
+constexpr auto SinC7 = static_cast<float>(-Pi*Pi*Pi*Pi*Pi*Pi*Pi / 5040.0);
+constexpr auto SinC9 = static_cast<float>(Pi*Pi*Pi*Pi*Pi*Pi*Pi*Pi*Pi / 362880.0);
+
+inline auto sin_pi_quarter(const float x) noexcept -> float
+{
+    const float x2{x*x};
+    return x*(SinC1 + x2*(SinC3 + x2*(SinC5 + x2*(SinC7 + x2*SinC9))));
+}
+
+/* Folds a signed phase value in -1...+1 to the rising quarter cycle, 0...0.5,
+ * for the magnitude of a sinusoid or triangle wave.
+ */
+inline auto fold_quarter(const float x) noexcept -> float
+{ return 0.5f - std::fabs(std::fabs(x) - 0.5f); }
+
+#ifdef HAVE_SSE_INTRINSICS
+/* Generates groups of four samples from their signed phase values, returning
+ * the number of samples written. Any remaining samples are left for the
+ * caller.
+ */
+template<typename F>
+auto generate_sse(const al::span<float> dst, const uint32_t start, const uint32_t step, F func)
+    noexcept -> size_t
+{
+    const size_t todo{dst.size() & ~size_t{3}};
+    __m128i phase{_mm_setr_epi32(static_cast<int>(start), static_cast<int>(start+step),
+        static_cast<int>(start+step*2u), static_cast<int>(start+step*3u))};
+    const __m128i step4{_mm_set1_epi32(static_cast<int>(step*4u))};
+    const __m128 scale{_mm_set1_ps(PhaseScale)};
+    for(size_t i{0};i < todo;i += 4)
+    {
+        const __m128 x{_mm_mul_ps(_mm_cvtepi32_ps(phase), scale)};
+        _mm_storeu_ps(&dst[i], func(x));
+        phase = _mm_add_epi32(phase, step4);
+    }
+    return todo;
+}
+
+inline auto fold_quarter4(const __m128 x) noexcept -> __m128
+{
+    const __m128 signbit{_mm_set1_ps(-0.0f)};
+    const __m128 half{_mm_set1_ps(0.5f)};
+    const __m128 ax{_mm_andnot_ps(signbit, x)};
+    return _mm_sub_ps(half, _mm_andnot_ps(signbit, _mm_sub_ps(ax, half)));
+}
+#endif
+
+} // namespace
+
+auto Lfo::phaseFromCycles(double cycles) noexcept -> uint32_t
+{
+    cycles -= std::floor(cycles);
+    return static_cast<uint32_t>(static_cast<uint64_t>(std::round(cycles * 4294967296.0)));
+}
+
+void Lfo::setRate(double rate) noexcept
+{
+    /* Keep under half a cycle per sample, otherwise the phase step would be
+     * interpreted as going backwards.
+     */
+    rate = std::clamp(rate, 0.0, 0.5);
+    mStep = static_cast<uint32_t>(std::min(std::round(rate * 4294967296.0), 2147483647.0));
+}
+
+void Lfo::generate(LfoWaveform waveform, const al::span<float> dst, uint32_t offset) const noexcept
+{
+    const uint32_t start{mPhase + offset};
+    const uint32_t step{mStep};
+
+    /* Each sample's phase is calculated independently from the start, rather
+     * than accumulated, so the loops have no dependencies between samples.
+     */
+    size_t base{0};
+    switch(waveform)
+    {
+    case LfoWaveform::Sinusoid:
+#ifdef HAVE_SSE_INTRINSICS
+        base = generate_sse(dst, start, step, [](const __m128 x) noexcept -> __m128
+        {
+            const __m128 y{fold_quarter4(x)};
+            const __m128 y2{_mm_mul_ps(y, y)};
+            __m128 r{_mm_add_ps(_mm_set1_ps(SinC7), _mm_mul_ps(y2, _mm_set1_ps(SinC9)))};
+            r = _mm_add_ps(_mm_set1_ps(SinC5), _mm_mul_ps(y2, r));
+            r = _mm_add_ps(_mm_set1_ps(SinC3), _mm_mul_ps(y2, r));
+            r = _mm_mul_ps(y, _mm_add_ps(_mm_set1_ps(SinC1), _mm_mul_ps(y2, r)));
+            /* The magnitude is never negative, so just copy the sign bit. */
+            return _mm_or_ps(r, _mm_and_ps(_mm_set1_ps(-0.0f), x));
+        });
+#endif
+        for(size_t i{base};i < dst.size();++i)
+        {
+            const float x{phase_to_signed(start + static_cast<uint32_t>(i)*step)};
+            dst[i] = std::copysign(sin_pi_quarter(fold_quarter(x)), x);
+        }
+        break;
+
+    case LfoWaveform::Triangle:
+#ifdef HAVE_SSE_INTRINSICS
+        base = generate_sse(dst, start, step, [](const __m128 x) noexcept -> __m128
+        {
+            const __m128 y{fold_quarter4(x)};
+            return _mm_or_ps(_mm_add_ps(y, y), _mm_and_ps(_mm_set1_ps(-0.0f), x));
+        });
+#endif
+        for(size_t i{base};i < dst.size();++i)
+        {
+            const float x{phase_to_signed(start + static_cast<uint32_t>(i)*step)};
+            dst[i] = std::copysign(fold_quarter(x)*2.0f, x);
+        }
+        break;
+
+    case LfoWaveform::Sawtooth:
+        for(size_t i{0};i < dst.size();++i)
+            dst[i] = phase_to_signed(start + static_cast<uint32_t>(i)*step + HalfCycle);
+        break;
+
+    case LfoWaveform::Square:
+        for(size_t i{0};i < dst.size();++i)
+        {
+            const auto x = static_cast<int32_t>(start + static_cast<uint32_t>(i)*step);
+            dst[i] = (x >= 0) ? 1.0f : -1.0f;
+        }
+        break;
+    }
+}
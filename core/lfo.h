@@ -0,0 +1,65 @@
+#ifndef CORE_LFO_H
+#define CORE_LFO_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "alspan.h"
+
+
+enum class LfoWaveform : std::uint8_t {
+    Sinusoid,
+    Triangle,
+    Sawtooth,
+    Square,
+};
+
+
+/* A low-frequency oscillator driven by a 32-bit fixed-point phase, where the
+ * full range of the phase is one cycle. The waveforms are calculated directly
+ * from the phase, without tables or trig functions, so a block of samples can
+ * be generated in one (vectorizable) pass.
+ *
+ * All waveforms go from -1 to +1. The sinusoid and triangle start at 0 and
+ * rise, while the sawtooth starts at -1 and the square starts at +1.
+ */
+class Lfo {
+    std::uint32_t mPhase{0u};
+    std::uint32_t mStep{0u};
+
+public:
+    static constexpr std::uint32_t QuarterCycle{0x40000000u};
+    static constexpr std::uint32_t HalfCycle{0x80000000u};
+
+    /** Converts a fraction of a cycle to a phase value. */
+    static auto phaseFromCycles(double cycles) noexcept -> std::uint32_t;
+
+    /**
+     * Sets the oscillation rate, in cycles per sample. The rate is limited to
+     * less than half a cycle per sample.
+     */
+    void setRate(double rate) noexcept;
+    /**
+     * Sets the phase step per sample directly. Unlike setRate, this allows
+     * steps of half a cycle or more, which alias to a slower rate going the
+     * other way.
+     */
+    void setStep(std::uint32_t step) noexcept { mStep = step; }
+    [[nodiscard]] auto isRunning() const noexcept -> bool { return mStep != 0; }
+
+    void setPhase(std::uint32_t phase) noexcept { mPhase = phase; }
+    [[nodiscard]] auto getPhase() const noexcept -> std::uint32_t { return mPhase; }
+
+    /**
+     * Writes the waveform to dst, starting from the current phase plus the
+     * given offset. The oscillator is not advanced.
+     */
+    void generate(LfoWaveform waveform, const al::span<float> dst,
+        std::uint32_t offset=0u) const noexcept;
+
+    /** Advances the oscillator phase by the given number of samples. */
+    void advance(std::size_t count) noexcept
+    { mPhase += static_cast<std::uint32_t>(count) * mStep; }
+};
+
+#endif /* CORE_LFO_H */
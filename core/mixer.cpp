@@ -8,17 +8,162 @@
 #include <utility>
 
 #include "alnumbers.h"
+#include "alnumeric.h"
+#include "bsinc_defs.h"
+#include "bsinc_tables.h"
 #include "core/ambidefs.h"
+#include "cpu_caps.h"
+#include "cubic_tables.h"
 #include "device.h"
 #include "mixer/defs.h"
 
 struct CTag;
+#ifdef HAVE_SSE
+struct SSETag;
+#endif
+#ifdef HAVE_SSE2
+struct SSE2Tag;
+#endif
+#ifdef HAVE_SSE4_1
+struct SSE4Tag;
+#endif
+#ifdef HAVE_NEON
+struct NEONTag;
+#endif
+struct PointTag;
+struct LerpTag;
+struct CubicTag;
+struct BSincTag;
+struct FastBSincTag;
 
 
 MixerOutFunc MixSamplesOut{Mix_<CTag>};
 MixerOneFunc MixSamplesOne{Mix_<CTag>};
 
 
+namespace {
+
+inline void BsincPrepare(const uint increment, BsincState *state, const BSincTable *table)
+{
+    size_t si{BSincScaleCount - 1};
+    float sf{0.0f};
+
+    if(increment > MixerFracOne)
+    {
+        sf = MixerFracOne/static_cast<float>(increment) - table->scaleBase;
+        sf = std::max(0.0f, BSincScaleCount*sf*table->scaleRange - 1.0f);
+        si = float2uint(sf);
+        /* The interpolation factor is fit to this diagonally-symmetric curve
+         * to reduce the transition ripple caused by interpolating different
+         * scales of the sinc function.
+         */
+        sf = 1.0f - std::cos(std::asin(sf - static_cast<float>(si)));
+    }
+
+    state->sf = sf;
+    state->m = table->m[si];
+    state->l = (state->m/2) - 1;
+    state->filter = table->Tab.subspan(table->filterOffset[si]);
+}
+
+inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
+{
+    switch(resampler)
+    {
+    case Resampler::Point:
+        return Resample_<PointTag,CTag>;
+    case Resampler::Linear:
+#ifdef HAVE_NEON
+        if((CPUCapFlags&CPU_CAP_NEON))
+            return Resample_<LerpTag,NEONTag>;
+#endif
+#ifdef HAVE_SSE4_1
+        if((CPUCapFlags&CPU_CAP_SSE4_1))
+            return Resample_<LerpTag,SSE4Tag>;
+#endif
+#ifdef HAVE_SSE2
+        if((CPUCapFlags&CPU_CAP_SSE2))
+            return Resample_<LerpTag,SSE2Tag>;
+#endif
+        return Resample_<LerpTag,CTag>;
+    case Resampler::Spline:
+    case Resampler::Gaussian:
+#ifdef HAVE_NEON
+        if((CPUCapFlags&CPU_CAP_NEON))
+            return Resample_<CubicTag,NEONTag>;
+#endif
+#ifdef HAVE_SSE4_1
+        if((CPUCapFlags&CPU_CAP_SSE4_1))
+            return Resample_<CubicTag,SSE4Tag>;
+#endif
+#ifdef HAVE_SSE2
+        if((CPUCapFlags&CPU_CAP_SSE2))
+            return Resample_<CubicTag,SSE2Tag>;
+#endif
+#ifdef HAVE_SSE
+        if((CPUCapFlags&CPU_CAP_SSE))
+            return Resample_<CubicTag,SSETag>;
+#endif
+        return Resample_<CubicTag,CTag>;
+    case Resampler::BSinc12:
+    case Resampler::BSinc24:
+        if(increment > MixerFracOne)
+        {
+#ifdef HAVE_NEON
+            if((CPUCapFlags&CPU_CAP_NEON))
+                return Resample_<BSincTag,NEONTag>;
+#endif
+#ifdef HAVE_SSE
+            if((CPUCapFlags&CPU_CAP_SSE))
+                return Resample_<BSincTag,SSETag>;
+#endif
+            return Resample_<BSincTag,CTag>;
+        }
+        /* fall-through */
+    case Resampler::FastBSinc12:
+    case Resampler::FastBSinc24:
+#ifdef HAVE_NEON
+        if((CPUCapFlags&CPU_CAP_NEON))
+            return Resample_<FastBSincTag,NEONTag>;
+#endif
+#ifdef HAVE_SSE
+        if((CPUCapFlags&CPU_CAP_SSE))
+            return Resample_<FastBSincTag,SSETag>;
+#endif
+        return Resample_<FastBSincTag,CTag>;
+    }
+
+    return Resample_<PointTag,CTag>;
+}
+
+} // namespace
+
+ResamplerFunc PrepareResampler(Resampler resampler, uint increment, InterpState *state)
+{
+    switch(resampler)
+    {
+    case Resampler::Point:
+    case Resampler::Linear:
+        break;
+    case Resampler::Spline:
+        state->emplace<CubicState>(al::span{gSplineFilter.mTable});
+        break;
+    case Resampler::Gaussian:
+        state->emplace<CubicState>(al::span{gGaussianFilter.mTable});
+        break;
+    case Resampler::FastBSinc12:
+    case Resampler::BSinc12:
+        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc12);
+        break;
+    case Resampler::FastBSinc24:
+    case Resampler::BSinc24:
+        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc24);
+        break;
+    }
+    return SelectResampler(resampler, increment);
+}
+
+
 std::array<float,MaxAmbiChannels> CalcAmbiCoeffs(const float y, const float z, const float x,
     const float spread)
 {
@@ -0,0 +1,112 @@
+
+#include "config.h"
+
+#include "mixprofile.h"
+
+#include <algorithm>
+
+
+namespace {
+
+/* Returns the index of the most significant set bit. The value must be
+ * non-0.
+ */
+constexpr auto msb_index(std::uint64_t value) noexcept -> std::size_t
+{
+    std::size_t ret{0};
+    for(std::size_t shift{32};shift > 0;shift >>= 1)
+    {
+        if(value >= (std::uint64_t{1} << shift))
+        {
+            value >>= shift;
+            ret += shift;
+        }
+    }
+    return ret;
+}
+
+constexpr auto bin_for_time(std::uint64_t nsec) noexcept -> std::size_t
+{
+    constexpr std::size_t SubBins{1u << MixerProfile::SubBinBits};
+    if(nsec < SubBins)
+        return static_cast<std::size_t>(nsec);
+
+    const std::size_t msb{msb_index(nsec)};
+    const std::size_t sub{(nsec >> (msb-MixerProfile::SubBinBits)) & (SubBins-1)};
+    return std::min(((msb-MixerProfile::SubBinBits+1) << MixerProfile::SubBinBits) + sub,
+        MixerProfile::NumBins-1);
+}
+
+/* Returns the (exclusive) upper limit of the times in the given bin. */
+constexpr auto bin_upper_limit(std::size_t bin) noexcept -> std::uint64_t
+{
+    constexpr std::size_t SubBins{1u << MixerProfile::SubBinBits};
+    if(bin < SubBins)
+        return bin + 1;
+
+    const std::size_t msb{(bin >> MixerProfile::SubBinBits) + MixerProfile::SubBinBits - 1};
+    const std::size_t sub{bin & (SubBins-1)};
+    return std::uint64_t{SubBins+sub+1} << (msb-MixerProfile::SubBinBits);
+}
+
+static_assert(bin_for_time(3) == 3);
+static_assert(bin_for_time(4) == 4 && bin_for_time(7) == 7 && bin_for_time(8) == 8);
+static_assert(bin_upper_limit(bin_for_time(1000)) > 1000);
+static_assert(bin_upper_limit(bin_for_time(1000)-1) <= 1000);
+
+} // namespace
+
+
+void MixerProfile::record(MixStage stage, std::uint64_t nsec) noexcept
+{
+    /* Only the mixer thread writes, so the counters don't need atomic
+     * read-modify-write operations, just atomic stores for the readers.
+     */
+    StageStats &stats = mStages[static_cast<std::size_t>(stage)];
+    auto &bin = stats.mBins[bin_for_time(nsec)];
+    bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    stats.mCount.store(stats.mCount.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    stats.mTotal.store(stats.mTotal.load(std::memory_order_relaxed) + nsec,
+        std::memory_order_relaxed);
+    if(nsec < stats.mMin.load(std::memory_order_relaxed))
+        stats.mMin.store(nsec, std::memory_order_relaxed);
+    if(nsec > stats.mMax.load(std::memory_order_relaxed))
+        stats.mMax.store(nsec, std::memory_order_relaxed);
+}
+
+auto MixerProfile::summarize(MixStage stage) const noexcept -> Summary
+{
+    const StageStats &stats = mStages[static_cast<std::size_t>(stage)];
+
+    Summary ret{};
+    ret.count = stats.mCount.load(std::memory_order_relaxed);
+    if(ret.count == 0)
+        return ret;
+
+    ret.min = stats.mMin.load(std::memory_order_relaxed);
+    ret.max = stats.mMax.load(std::memory_order_relaxed);
+    ret.avg = stats.mTotal.load(std::memory_order_relaxed) / ret.count;
+
+    /* Find the bin containing the 99th percentile, and report its upper limit
+     * (clamped to the maximum seen). The bins may be slightly out of sync with
+     * the count if the mixer is running, so count them directly.
+     */
+    std::uint64_t total{0};
+    for(const auto &bin : stats.mBins)
+        total += bin.load(std::memory_order_relaxed);
+    const std::uint64_t target{total - total/100};
+
+    std::uint64_t accum{0};
+    for(std::size_t i{0};i < stats.mBins.size();++i)
+    {
+        accum += stats.mBins[i].load(std::memory_order_relaxed);
+        if(accum >= target)
+        {
+            ret.p99 = std::clamp(bin_upper_limit(i), ret.min, ret.max);
+            break;
+        }
+    }
+
+    return ret;
+}
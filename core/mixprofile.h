@@ -0,0 +1,95 @@
+#ifndef CORE_MIXPROFILE_H
+#define CORE_MIXPROFILE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+/* The stages of a mixing pass that get timed. Voices, parameter updates, and
+ * effects are recorded per context and per effect slot, respectively, while
+ * the rest are recorded once per pass.
+ */
+enum class MixStage : std::uint8_t {
+    ParamUpdates,
+    Voices,
+    Effects,
+    PostProcess,
+    Limiter,
+    DistanceComp,
+    Dither,
+    Write,
+    Total,
+};
+inline constexpr std::size_t MixStageCount{static_cast<std::size_t>(MixStage::Total) + 1};
+
+
+/* Collects timing histograms for each mixing stage. Recording is done only by
+ * the mixer thread, while the summaries may be read from any thread at any
+ * time (a summary taken while mixing may be off by the pass in progress).
+ */
+class MixerProfile {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /* Each power-of-two range of nanoseconds is split into 4 bins, giving
+     * roughly 19% resolution for the percentile, up to about 8 seconds.
+     */
+    static constexpr std::size_t SubBinBits{2};
+    static constexpr std::size_t NumBins{32u << SubBinBits};
+
+    struct Summary {
+        std::uint64_t count;
+        std::uint64_t min; /* Nanoseconds */
+        std::uint64_t avg;
+        std::uint64_t p99;
+        std::uint64_t max;
+    };
+
+private:
+    struct StageStats {
+        std::array<std::atomic<std::uint32_t>,NumBins> mBins{};
+        std::atomic<std::uint64_t> mCount{0u};
+        std::atomic<std::uint64_t> mTotal{0u};
+        std::atomic<std::uint64_t> mMin{~std::uint64_t{0u}};
+        std::atomic<std::uint64_t> mMax{0u};
+    };
+    std::array<StageStats,MixStageCount> mStages;
+
+    clock::time_point mPassStart;
+    clock::time_point mLapStart;
+
+    void record(MixStage stage, std::uint64_t nsec) noexcept;
+
+public:
+    /** Marks the start of a mixing pass. */
+    void beginPass() noexcept { mPassStart = mLapStart = clock::now(); }
+    /** Records the time for the whole pass. */
+    void endPass() noexcept
+    {
+        const auto now = clock::now();
+        record(MixStage::Total, static_cast<std::uint64_t>(
+            std::chrono::nanoseconds{now - mPassStart}.count()));
+        mLapStart = now;
+    }
+
+    /** Restarts the stage timer without recording anything. */
+    void mark() noexcept { mLapStart = clock::now(); }
+    /**
+     * Records the time since the last mark or lap to the given stage, and
+     * restarts the stage timer.
+     */
+    void lap(MixStage stage) noexcept
+    {
+        const auto now = clock::now();
+        record(stage, static_cast<std::uint64_t>(
+            std::chrono::nanoseconds{now - mLapStart}.count()));
+        mLapStart = now;
+    }
+
+    [[nodiscard]] auto summarize(MixStage stage) const noexcept -> Summary;
+};
+
+#endif /* CORE_MIXPROFILE_H */
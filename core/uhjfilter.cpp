@@ -116,21 +116,6 @@ const SegmentedFilter<N> gSegmentedFilter;
 template<size_t N>
 const PhaseShifterT<N> PShifter;
 
-
-/* Filter coefficients for the 'base' all-pass IIR, which applies a frequency-
- * dependent phase-shift of N degrees. The output of the filter requires a 1-
- * sample delay.
- */
-constexpr std::array<float,4> Filter1Coeff{{
-    0.479400865589f, 0.876218493539f, 0.976597589508f, 0.997499255936f
-}};
-/* Filter coefficients for the offset all-pass IIR, which applies a frequency-
- * dependent phase-shift of N+90 degrees.
- */
-constexpr std::array<float,4> Filter2Coeff{{
-    0.161758498368f, 0.733028932341f, 0.945349700329f, 0.990599156684f
-}};
-
 } // namespace
 
 void UhjAllPassFilter::processOne(const al::span<const float, 4> coeffs, float x)
@@ -351,17 +336,17 @@ void UhjEncoderIIR::encode(float *LeftOut, float *RightOut,
     /* S = 0.9396926*W + 0.1855740*X */
     std::transform(winput.begin(), winput.end(), xinput.begin(), mTemp.begin(),
         [](const float w, const float x) noexcept { return 0.9396926f*w + 0.1855740f*x; });
-    mFilter1WX.process(Filter1Coeff, al::span{mTemp}.first(SamplesToDo), true,
+    mFilter1WX.process(UhjAllPass1Coeffs, al::span{mTemp}.first(SamplesToDo), true,
         al::span{mS}.subspan(1));
     mS[0] = mDelayWX; mDelayWX = mS[SamplesToDo];
 
     /* Precompute j(-0.3420201*W + 0.5098604*X) and store in mWX. */
     std::transform(winput.begin(), winput.end(), xinput.begin(), mTemp.begin(),
         [](const float w, const float x) noexcept { return -0.3420201f*w + 0.5098604f*x; });
-    mFilter2WX.process(Filter2Coeff, al::span{mTemp}.first(SamplesToDo), true, mWX);
+    mFilter2WX.process(UhjAllPass2Coeffs, al::span{mTemp}.first(SamplesToDo), true, mWX);
 
     /* Apply filter1 to Y and store in mD. */
-    mFilter1Y.process(Filter1Coeff, yinput, true, al::span{mD}.subspan(1));
+    mFilter1Y.process(UhjAllPass1Coeffs, yinput, true, al::span{mD}.subspan(1));
     mD[0] = mDelayY; mDelayY = mD[SamplesToDo];
 
     /* D = j(-0.3420201*W + 0.5098604*X) + 0.6554516*Y */
@@ -372,7 +357,7 @@ void UhjEncoderIIR::encode(float *LeftOut, float *RightOut,
      * signal.
      */
     const auto left = al::span{al::assume_aligned<16>(LeftOut), SamplesToDo};
-    mFilter1Direct[0].process(Filter1Coeff, left, true, al::span{mTemp}.subspan(1));
+    mFilter1Direct[0].process(UhjAllPass1Coeffs, left, true, al::span{mTemp}.subspan(1));
     mTemp[0] = mDirectDelay[0]; mDirectDelay[0] = mTemp[SamplesToDo];
 
     /* Left = (S + D)/2.0 */
@@ -380,7 +365,7 @@ void UhjEncoderIIR::encode(float *LeftOut, float *RightOut,
         left[i] = (mS[i] + mD[i])*0.5f + mTemp[i];
 
     const auto right = al::span{al::assume_aligned<16>(RightOut), SamplesToDo};
-    mFilter1Direct[1].process(Filter1Coeff, right, true, al::span{mTemp}.subspan(1));
+    mFilter1Direct[1].process(UhjAllPass1Coeffs, right, true, al::span{mTemp}.subspan(1));
     mTemp[0] = mDirectDelay[1]; mDirectDelay[1] = mTemp[SamplesToDo];
 
     /* Right = (S - D)/2.0 */
@@ -495,11 +480,11 @@ void UhjDecoderIIR::decode(const al::span<float*> samples, const size_t samplesT
     std::transform(mD.cbegin(), mD.cbegin()+sInputPadding+samplesToDo, youtput.begin(),
         mTemp.begin(),
         [](const float d, const float t) noexcept { return 0.828331f*d + 0.767820f*t; });
-    if(mFirstRun) mFilter2DT.processOne(Filter2Coeff, mTemp[0]);
-    mFilter2DT.process(Filter2Coeff, al::span{mTemp}.subspan(1,samplesToDo), updateState, xoutput);
+    if(mFirstRun) mFilter2DT.processOne(UhjAllPass2Coeffs, mTemp[0]);
+    mFilter2DT.process(UhjAllPass2Coeffs, al::span{mTemp}.subspan(1,samplesToDo), updateState, xoutput);
 
     /* Apply filter1 to S and store in mTemp. */
-    mFilter1S.process(Filter1Coeff, al::span{mS}.first(samplesToDo), updateState, mTemp);
+    mFilter1S.process(UhjAllPass1Coeffs, al::span{mS}.first(samplesToDo), updateState, mTemp);
 
     /* W = 0.981532*S + 0.197484*j(0.828331*D + 0.767820*T) */
     std::transform(mTemp.begin(), mTemp.begin()+samplesToDo, xoutput.begin(), woutput.begin(),
@@ -512,11 +497,11 @@ void UhjDecoderIIR::decode(const al::span<float*> samples, const size_t samplesT
     /* Apply filter1 to (0.795968*D - 0.676392*T) and store in mTemp. */
     std::transform(mD.cbegin(), mD.cbegin()+samplesToDo, youtput.begin(), youtput.begin(),
         [](const float d, const float t) noexcept { return 0.795968f*d - 0.676392f*t; });
-    mFilter1DT.process(Filter1Coeff, youtput.first(samplesToDo), updateState, mTemp);
+    mFilter1DT.process(UhjAllPass1Coeffs, youtput.first(samplesToDo), updateState, mTemp);
 
     /* Precompute j*S and store in youtput. */
-    if(mFirstRun) mFilter2S.processOne(Filter2Coeff, mS[0]);
-    mFilter2S.process(Filter2Coeff, al::span{mS}.subspan(1, samplesToDo), updateState, youtput);
+    if(mFirstRun) mFilter2S.processOne(UhjAllPass2Coeffs, mS[0]);
+    mFilter2S.process(UhjAllPass2Coeffs, al::span{mS}.subspan(1, samplesToDo), updateState, youtput);
 
     /* Y = 0.795968*D - 0.676392*T + j(0.186633*S) */
     std::transform(mTemp.begin(), mTemp.begin()+samplesToDo, youtput.begin(), youtput.begin(),
@@ -527,7 +512,7 @@ void UhjDecoderIIR::decode(const al::span<float*> samples, const size_t samplesT
         const auto zoutput = al::span{al::assume_aligned<16>(samples[3]), samplesToDo};
 
         /* Apply filter1 to Q and store in mTemp. */
-        mFilter1Q.process(Filter1Coeff, zoutput, updateState, mTemp);
+        mFilter1Q.process(UhjAllPass1Coeffs, zoutput, updateState, mTemp);
 
         /* Z = 1.023332*Q */
         std::transform(mTemp.begin(), mTemp.end(), zoutput.begin(),
@@ -683,11 +668,11 @@ void UhjStereoDecoderIIR::decode(const al::span<float*> samples, const size_t sa
     const auto youtput = al::span{al::assume_aligned<16>(samples[2]), samplesToDo};
 
     /* Apply filter1 to S and store in mTemp. */
-    mFilter1S.process(Filter1Coeff, al::span{mS}.first(samplesToDo), updateState, mTemp);
+    mFilter1S.process(UhjAllPass1Coeffs, al::span{mS}.first(samplesToDo), updateState, mTemp);
 
     /* Precompute j*D and store in xoutput. */
-    if(mFirstRun) mFilter2D.processOne(Filter2Coeff, mD[0]);
-    mFilter2D.process(Filter2Coeff, al::span{mD}.subspan(1, samplesToDo), updateState, xoutput);
+    if(mFirstRun) mFilter2D.processOne(UhjAllPass2Coeffs, mD[0]);
+    mFilter2D.process(UhjAllPass2Coeffs, al::span{mD}.subspan(1, samplesToDo), updateState, xoutput);
 
     /* W = 0.6098637*S + 0.6896511*j*w*D */
     std::transform(mTemp.begin(), mTemp.begin()+samplesToDo, xoutput.begin(), woutput.begin(),
@@ -697,11 +682,11 @@ void UhjStereoDecoderIIR::decode(const al::span<float*> samples, const size_t sa
         [](const float s, const float jd) noexcept { return 0.8624776f*s - 0.7626955f*jd; });
 
     /* Precompute j*S and store in youtput. */
-    if(mFirstRun) mFilter2S.processOne(Filter2Coeff, mS[0]);
-    mFilter2S.process(Filter2Coeff, al::span{mS}.subspan(1, samplesToDo), updateState, youtput);
+    if(mFirstRun) mFilter2S.processOne(UhjAllPass2Coeffs, mS[0]);
+    mFilter2S.process(UhjAllPass2Coeffs, al::span{mS}.subspan(1, samplesToDo), updateState, youtput);
 
     /* Apply filter1 to D and store in mTemp. */
-    mFilter1D.process(Filter1Coeff, al::span{mD}.first(samplesToDo), updateState, mTemp);
+    mFilter1D.process(UhjAllPass1Coeffs, al::span{mD}.first(samplesToDo), updateState, mTemp);
 
     /* Y = 1.6822415*w*D + 0.2156194*j*S */
     std::transform(mTemp.begin(), mTemp.begin()+samplesToDo, youtput.begin(), youtput.begin(),
@@ -24,6 +24,20 @@ inline UhjQualityType UhjDecodeQuality{UhjQualityType::Default};
 inline UhjQualityType UhjEncodeQuality{UhjQualityType::Default};
 
 
+/* Filter coefficients for the 'base' all-pass IIR, which applies a frequency-
+ * dependent phase-shift of N degrees. The output of the filter requires a 1-
+ * sample delay.
+ */
+inline constexpr std::array<float,4> UhjAllPass1Coeffs{{
+    0.479400865589f, 0.876218493539f, 0.976597589508f, 0.997499255936f
+}};
+/* Filter coefficients for the offset all-pass IIR, which applies a frequency-
+ * dependent phase-shift of N+90 degrees.
+ */
+inline constexpr std::array<float,4> UhjAllPass2Coeffs{{
+    0.161758498368f, 0.733028932341f, 0.945349700329f, 0.990599156684f
+}};
+
 struct UhjAllPassFilter {
     struct AllPassState {
         /* Last two delayed components for direct form II. */
@@ -10,6 +10,7 @@
 #include <climits>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <new>
@@ -27,6 +28,7 @@
 #include "cpu_caps.h"
 #include "devformat.h"
 #include "device.h"
+#include "effectslot.h"
 #include "filters/biquad.h"
 #include "filters/nfc.h"
 #include "filters/splitter.h"
@@ -227,7 +229,7 @@ constexpr std::array MSADPCMAdaptionCoeff{
 };
 
 
-void SendSourceStoppedEvent(ContextBase *context, uint id)
+void SendSourceStateEvent(ContextBase *context, uint id, AsyncSrcState state)
 {
     RingBuffer *ring{context->mAsyncEvents.get()};
     auto evt_vec = ring->getWriteVector();
@@ -235,7 +237,7 @@ void SendSourceStoppedEvent(ContextBase *context, uint id)
 
     auto &evt = InitAsyncEvent<AsyncSourceStateEvent>(evt_vec.first.buf);
     evt.mId = id;
-    evt.mState = AsyncSrcState::Stop;
+    evt.mState = state;
 
     ring->writeAdvance(1);
 }
@@ -715,10 +717,81 @@ void DoNfcMix(const al::span<const float> samples, al::span<FloatBufferLine> Out
 
 void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds deviceTime,
     const uint SamplesToDo)
+{
+    /* Check for a scheduled stop or pause in this update. */
+    if(vstate != Playing || mStopTime >= deviceTime+seconds{1}) LIKELY
+        return mixRange(vstate, Context, deviceTime, 0, SamplesToDo);
+
+    const auto diff = std::max(mStopTime - deviceTime, nanoseconds::zero());
+    const auto stopPos = static_cast<uint>(std::min<int64_t>(SamplesToDo,
+        round<seconds>(diff * Context->mDevice->Frequency).count()));
+    if(stopPos >= SamplesToDo)
+        return mixRange(vstate, Context, deviceTime, 0, SamplesToDo);
+
+    /* Play up to the stop point, then fade out from there as if stopped or
+     * paused, so the change is sample accurate.
+     */
+    if(stopPos > 0)
+    {
+        mixRange(Playing, Context, deviceTime, 0, stopPos);
+        /* Nothing left to do if it ended on its own. */
+        if(mPlayState.load(std::memory_order_relaxed) != Playing)
+            return;
+    }
+
+    mStopTime = nanoseconds::max();
+    const auto enabledevt = Context->mEnabledEvts.load(std::memory_order_acquire);
+    if(mStopPauses)
+    {
+        /* A paused voice keeps its source and position, and fading out won't
+         * move it.
+         */
+        mPlayState.store(Stopping, std::memory_order_relaxed);
+        mixRange(Stopping, Context, deviceTime, stopPos, SamplesToDo);
+        mMixerPaused.store(true, std::memory_order_release);
+
+        if(enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
+            SendSourceStateEvent(Context, mSourceID.load(std::memory_order_relaxed),
+                AsyncSrcState::Pause);
+        return;
+    }
+
+    const uint SourceID{mSourceID.exchange(0u, std::memory_order_relaxed)};
+    mixRange(Stopping, Context, deviceTime, stopPos, SamplesToDo);
+    mCurrentBuffer.store(nullptr, std::memory_order_relaxed);
+    mLoopBuffer.store(nullptr, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if(enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
+        SendSourceStateEvent(Context, SourceID, AsyncSrcState::Stop);
+}
+
+auto Voice::getRampGain(const nanoseconds time) const noexcept -> float
+{
+    if(time <= mRampStart || mRampGain == mRampTarget)
+        return mRampGain;
+    if(time >= mRampEnd)
+        return mRampTarget;
+    const auto frac = static_cast<float>(duration<double>{time - mRampStart}
+        / duration<double>{mRampEnd - mRampStart});
+    return lerpf(mRampGain, mRampTarget, frac);
+}
+
+void Voice::setRampGain(const nanoseconds curtime, const float target, const nanoseconds start,
+    const nanoseconds end) noexcept
+{
+    mRampGain = getRampGain(curtime);
+    mRampTarget = target;
+    mRampStart = start;
+    mRampEnd = end;
+}
+
+void Voice::mixRange(const State vstate, ContextBase *Context, const nanoseconds deviceTime,
+    const uint OutStart, const uint SamplesToDo)
 {
     static constexpr std::array<float,MaxOutputChannels> SilentTarget{};
 
-    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo > OutStart);
 
     DeviceBase *Device{Context->mDevice};
     const uint NumSends{Device->NumAuxSends};
@@ -748,7 +821,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
             BufferLoopItem = nullptr;
     }
 
-    uint OutPos{0u};
+    uint OutPos{OutStart};
 
     /* Check if we're doing a delayed start, and we start in this update. */
     if(mStartTime > deviceTime) UNLIKELY
@@ -771,7 +844,8 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
          * should start at. Skip this update if it's beyond the output sample
          * count.
          */
-        OutPos = static_cast<uint>(round<seconds>(diff * Device->Frequency).count());
+        OutPos = std::max(OutPos,
+            static_cast<uint>(round<seconds>(diff * Device->Frequency).count()));
         if(OutPos >= SamplesToDo) return;
     }
 
@@ -1015,6 +1089,38 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
         }
     }
 
+    /* Apply any scheduled gain, computing it for each sample while it's
+     * ramping.
+     */
+    if(mRampGain != 1.0f || mRampTarget != 1.0f) UNLIKELY
+    {
+        /* A MonoDup voice's second channel is the same as the first. */
+        const auto gainSamples = MixingSamples.first((mFmtChannels == FmtMonoDup) ? 1u
+            : MixingSamples.size());
+        const auto sampleTime = [deviceTime,Device](const uint pos) noexcept
+        { return deviceTime + nanoseconds{seconds{pos}}/Device->Frequency; };
+        if(mRampGain == mRampTarget || sampleTime(SamplesToDo) <= mRampStart)
+        {
+            const float gain{mRampGain};
+            for(float *samples : gainSamples)
+                std::transform(samples, samples+samplesToMix, samples,
+                    [gain](const float sample) noexcept { return sample * gain; });
+        }
+        else
+        {
+            const auto gains = al::span{Device->FilteredData}.first(samplesToMix);
+            uint pos{OutPos};
+            std::generate(gains.begin(), gains.end(),
+                [this,&sampleTime,&pos] { return getRampGain(sampleTime(pos++)); });
+            for(float *samples : gainSamples)
+                std::transform(samples, samples+samplesToMix, gains.begin(), samples,
+                    std::multiplies<>{});
+
+            if(sampleTime(SamplesToDo) >= mRampEnd)
+                mRampGain = mRampTarget;
+        }
+    }
+
     const uint Counter{mFlags.test(VoiceIsFading) ? std::min(samplesToMix, 64u) : 0u};
     if(!Counter)
     {
@@ -1080,6 +1186,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 : al::span{SilentTarget};
             MixSamples(samples, mSend[send].Buffer, parms.Gains.Current, TargetGains, Counter,
                 OutPos);
+            mSend[send].Slot->mHasInput = true;
         }
 
         ++voiceSamples;
@@ -1198,7 +1305,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
          */
         mPlayState.store(Stopping, std::memory_order_release);
         if(enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
-            SendSourceStoppedEvent(Context, SourceID);
+            SendSourceStateEvent(Context, SourceID, AsyncSrcState::Stop);
     }
 }
 
@@ -196,6 +196,15 @@ struct SIMDALIGN Voice {
     std::atomic<State> mPlayState{Stopped};
     std::atomic<bool> mPendingChange{false};
 
+    /* Index in the context's voice array, and the links for the context's
+     * free voice list.
+     */
+    uint mVoiceIdx{0u};
+    std::atomic<Voice*> mNextFree{nullptr};
+    std::atomic<bool> mInFreeList{false};
+    /* Set while the voice is in the mixer's list of voices to process. */
+    bool mInMixList{false};
+
     /**
      * Source offset in samples, relative to the currently playing buffer, NOT
      * the whole queue.
@@ -213,6 +222,23 @@ struct SIMDALIGN Voice {
     std::atomic<VoiceBufferItem*> mLoopBuffer{};
 
     std::chrono::nanoseconds mStartTime{};
+    /* Device clock time to stop or pause at, if scheduled. Only the mixer
+     * sets this once the voice is playing.
+     */
+    std::chrono::nanoseconds mStopTime{std::chrono::nanoseconds::max()};
+    bool mStopPauses{false};
+    /* Set by the mixer when it pauses the voice for a scheduled pause, for
+     * the source to pick up.
+     */
+    std::atomic<bool> mMixerPaused{false};
+
+    /* Extra gain from scheduled gain ramps. The gain is mRampGain until
+     * mRampStart, then moves linearly to mRampTarget by mRampEnd.
+     */
+    float mRampGain{1.0f};
+    float mRampTarget{1.0f};
+    std::chrono::nanoseconds mRampStart{};
+    std::chrono::nanoseconds mRampEnd{};
 
     /* Properties for the attached buffer(s). */
     FmtChannels mFmtChannels{};
@@ -242,6 +268,10 @@ struct SIMDALIGN Voice {
     struct TargetData {
         int FilterType{};
         al::span<FloatBufferLine> Buffer;
+        /* The effect slot owning Buffer, for sends. Marked as having input
+         * when mixed into.
+         */
+        EffectSlot *Slot{nullptr};
     };
     TargetData mDirect;
     std::array<TargetData,MaxSendCount> mSend;
@@ -271,6 +301,14 @@ struct SIMDALIGN Voice {
 
     void mix(const State vstate, ContextBase *Context, const std::chrono::nanoseconds deviceTime,
         const uint SamplesToDo);
+    void mixRange(const State vstate, ContextBase *Context,
+        const std::chrono::nanoseconds deviceTime, const uint OutStart, const uint SamplesToDo);
+
+    /* Returns the scheduled gain ramp's gain at the given device clock time. */
+    [[nodiscard]] auto getRampGain(const std::chrono::nanoseconds time) const noexcept -> float;
+    /* Starts a new gain ramp, from the gain at the given device clock time. */
+    void setRampGain(const std::chrono::nanoseconds curtime, const float target,
+        const std::chrono::nanoseconds start, const std::chrono::nanoseconds end) noexcept;
 
     void prepare(DeviceBase *device);
 
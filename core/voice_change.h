@@ -2,6 +2,7 @@
 #define VOICE_CHANGE_H
 
 #include <atomic>
+#include <chrono>
 
 struct Voice;
 
@@ -13,13 +14,22 @@ enum class VChangeState {
     Stop,
     Play,
     Pause,
-    Restart
+    Restart,
+    StopAt,
+    PauseAt,
+    GainRamp
 };
 struct VoiceChange {
     Voice *mOldVoice{nullptr};
     Voice *mVoice{nullptr};
     uint mSourceID{0};
     VChangeState mState{};
+    /* Device clock time for scheduled changes, and the end time and target
+     * gain for gain ramps.
+     */
+    std::chrono::nanoseconds mTime{};
+    std::chrono::nanoseconds mEndTime{};
+    float mGain{};
 
     std::atomic<VoiceChange*> mNext{nullptr};
 };
@@ -0,0 +1,59 @@
+#ifndef TESTS_ALCONF_ENV_H
+#define TESTS_ALCONF_ENV_H
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+/* Writes the given config text to a temporary file and points ALSOFT_CONF at
+ * it before any test runs, then removes the file once they're all done. Add it
+ * with ::testing::AddGlobalTestEnvironment.
+ */
+class AlConfEnvironment : public ::testing::Environment {
+    std::string mName;
+    std::string mText;
+    std::filesystem::path mConfPath;
+
+public:
+    /* The name is used in the file name, to tell the test programs' configs
+     * apart.
+     */
+    AlConfEnvironment(std::string name, std::string text)
+        : mName{std::move(name)}, mText{std::move(text)}
+    { }
+
+    void SetUp() override
+    {
+        const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        mConfPath = std::filesystem::temp_directory_path()
+            / ("alsoft-" + mName + "-" + std::to_string(stamp) + ".conf");
+
+        std::ofstream conf{mConfPath};
+        conf << mText;
+        conf.close();
+        ASSERT_TRUE(conf.good()) << "Failed to write " << mConfPath;
+
+#ifdef _WIN32
+        _putenv_s("ALSOFT_CONF", mConfPath.string().c_str());
+#else
+        setenv("ALSOFT_CONF", mConfPath.c_str(), 1);
+#endif
+    }
+
+    void TearDown() override
+    {
+        if(!mConfPath.empty())
+        {
+            std::error_code ec;
+            std::filesystem::remove(mConfPath, ec);
+        }
+    }
+};
+
+#endif /* TESTS_ALCONF_ENV_H */
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+/* Renders through a loopback device, to check what a device renders after
+ * being reset.
+ */
+
+namespace {
+
+constexpr ALCint TestRate{48000};
+constexpr ALCsizei ChunkFrames{256};
+constexpr int NumChunks{32};
+
+
+class DeviceResetTest : public ::testing::Test {
+};
+
+/* Plays a B-Format source with only the X channel set, which needs the first-
+ * order channels of the device mix to be heard, and returns the rendered
+ * samples. Returns an empty vector on failure.
+ */
+std::vector<float> RenderBFormat(bool reset)
+{
+    ALCdevice *device{alcLoopbackOpenDeviceSOFT(nullptr)};
+    if(!device)
+        return {};
+
+    const std::array<ALCint,7> attrs{{ALC_FREQUENCY, TestRate, ALC_FORMAT_CHANNELS_SOFT,
+        ALC_STEREO_SOFT, ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT, 0}};
+    ALCcontext *context{alcCreateContext(device, attrs.data())};
+    if(!context || !alcMakeContextCurrent(context))
+    {
+        if(context)
+            alcDestroyContext(context);
+        alcCloseDevice(device);
+        return {};
+    }
+
+    /* An unchanged reset keeps the renderer, which still has to mix with the
+     * same ambisonic order as before.
+     */
+    if(reset && !alcResetDeviceSOFT(device, attrs.data()))
+    {
+        alcMakeContextCurrent(nullptr);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return {};
+    }
+
+    constexpr size_t NumFrames{4800};
+    std::vector<ALshort> data(NumFrames * 3);
+    for(size_t i{0};i < NumFrames;++i)
+    {
+        constexpr double Pi{3.14159265358979323846};
+        /* 500hz at 48khz loops seamlessly over 4800 samples. */
+        data[i*3 + 1] = static_cast<ALshort>(std::lround(16384.0
+            * std::sin(2.0*Pi * 500.0 * static_cast<double>(i) / TestRate)));
+    }
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_BFORMAT2D_16, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(ALshort)), TestRate);
+
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+    alSourcei(source, AL_LOOPING, AL_TRUE);
+    alSourcePlay(source);
+
+    std::vector<float> samples(static_cast<size_t>(ChunkFrames) * 2 * NumChunks);
+    for(int i{0};i < NumChunks;++i)
+        alcRenderSamplesSOFT(device, &samples[static_cast<size_t>(ChunkFrames)*2*i],
+            ChunkFrames);
+    const ALenum err{alGetError()};
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffer);
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    if(err != AL_NO_ERROR)
+        return {};
+    return samples;
+}
+
+TEST_F(DeviceResetTest, UnchangedResetKeepsAmbisonicMix)
+{
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+        GTEST_SKIP() << "ALC_SOFT_loopback not supported";
+
+    const auto reference = RenderBFormat(false);
+    ASSERT_FALSE(reference.empty()) << "Failed to render through a loopback device";
+    ASSERT_TRUE(std::any_of(reference.cbegin(), reference.cend(),
+        [](const float s) { return s != 0.0f; })) << "The reference render is silent";
+
+    const auto afterreset = RenderBFormat(true);
+    ASSERT_EQ(afterreset.size(), reference.size())
+        << "Failed to render through a loopback device after a reset";
+
+    const auto mismatch = std::mismatch(afterreset.cbegin(), afterreset.cend(),
+        reference.cbegin());
+    EXPECT_TRUE(mismatch.first == afterreset.cend())
+        << "Output changed after resetting the device, at frame "
+        << (mismatch.first - afterreset.cbegin()) / 2;
+}
+
+} // namespace
@@ -0,0 +1,683 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+#include <AL/efx.h>
+
+#include "alconf_env.h"
+
+/* Renders scripted scenes through a loopback device and compares them against
+ * the reference renders in the golden/ directory. Each scene is run once for
+ * every CPU extension level the mixer dispatches on. The extensions are
+ * selected with the disable-cpu-exts config option, so there's a separate test
+ * program for each level, with GOLDEN_CPU_LEVEL naming the level it tests.
+ *
+ * The reference renders are made with the C level. Running the tests with
+ * ALSOFT_GOLDEN_UPDATE=1 in the environment rewrites them.
+ *
+ * A render from the C level must be bit-exact with a reference made on the
+ * same architecture, while other levels (and other architectures) only need
+ * to reach a minimum signal-to-noise ratio against it. The ratio can be
+ * changed with ALSOFT_GOLDEN_MIN_SNR, and setting ALSOFT_GOLDEN_EXACT=0 allows
+ * the C level to use it too.
+ *
+ * When GOLDEN_EFFECT_THREADS is defined, the scenes are rendered with that
+ * many effect threads instead. The threads sum the slots' outputs in a
+ * different order than the serial path, so those renders are always compared
+ * by their signal-to-noise ratio, and never written as references.
+ */
+
+namespace {
+
+constexpr ALCint GoldenRate{48000};
+constexpr ALCsizei ChunkFrames{256};
+constexpr int NumChunks{48};
+constexpr ALCsizei SceneFrames{ChunkFrames * NumChunks};
+constexpr double DefaultMinSnr{60.0};
+#ifdef GOLDEN_EFFECT_THREADS
+constexpr unsigned int EffectThreads{GOLDEN_EFFECT_THREADS};
+#else
+constexpr unsigned int EffectThreads{0};
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+constexpr char GoldenArch[]{"x86_64"};
+#elif defined(__i386__) || defined(_M_IX86)
+constexpr char GoldenArch[]{"x86"};
+#elif defined(__aarch64__) || defined(_M_ARM64)
+constexpr char GoldenArch[]{"aarch64"};
+#elif defined(__arm__) || defined(_M_ARM)
+constexpr char GoldenArch[]{"arm"};
+#else
+constexpr char GoldenArch[]{"other"};
+#endif
+
+
+struct CpuLevel {
+    const char *name;
+    /* The disable-cpu-exts value that leaves just this level enabled. */
+    const char *disabled;
+    bool (*supported)();
+};
+
+bool HasNothing() { return true; }
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+bool HasSSE() { return __builtin_cpu_supports("sse"); }
+bool HasSSE2() { return __builtin_cpu_supports("sse2"); }
+bool HasSSE3() { return __builtin_cpu_supports("sse3"); }
+bool HasSSE4_1() { return __builtin_cpu_supports("sse4.1"); }
+#elif defined(_M_X64) || defined(_M_IX86)
+bool HasSSE() { return true; }
+bool HasSSE2() { return true; }
+bool HasSSE3() { return true; }
+bool HasSSE4_1() { return true; }
+#else
+bool HasSSE() { return false; }
+bool HasSSE2() { return false; }
+bool HasSSE3() { return false; }
+bool HasSSE4_1() { return false; }
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+bool HasNEON() { return true; }
+#else
+bool HasNEON() { return false; }
+#endif
+
+/* New dispatch levels should be added here as the mixer gains them. */
+const std::array CpuLevels{
+    CpuLevel{"c", "all", HasNothing},
+    CpuLevel{"sse", "sse2, sse3, sse4.1, neon", HasSSE},
+    CpuLevel{"sse2", "sse3, sse4.1, neon", HasSSE2},
+    CpuLevel{"sse3", "sse4.1, neon", HasSSE3},
+    CpuLevel{"sse4_1", "neon", HasSSE4_1},
+    CpuLevel{"neon", "sse, sse2, sse3, sse4.1", HasNEON},
+};
+
+
+/* Returns the CPU level this program tests, or null if GOLDEN_CPU_LEVEL isn't
+ * a known level.
+ */
+const CpuLevel *GetTestLevel()
+{
+    const auto iter = std::find_if(CpuLevels.cbegin(), CpuLevels.cend(),
+        [](const CpuLevel &lvl) { return std::string_view{lvl.name} == GOLDEN_CPU_LEVEL; });
+    return (iter != CpuLevels.cend()) ? &*iter : nullptr;
+}
+
+/* Returns the config for the tested CPU level. Everything that affects the
+ * output is pinned, in case there's a user config.
+ */
+std::string MakeConfig()
+{
+    const CpuLevel *level{GetTestLevel()};
+    std::ostringstream conf;
+    conf<< "[general]\n"
+        << "disable-cpu-exts = " << (level ? level->disabled : "") << "\n"
+        << "hrtf-paths = " << HRTF_DATA_DIR << "\n"
+        << "resampler = gaussian\n"
+        << "sends = 4\n"
+        << "dither = true\n"
+        << "output-limiter = true\n"
+        << "volume-adjust = 0\n"
+        << "front-stablizer = false\n"
+        << "effect-threads = " << EffectThreads << "\n"
+        << "[decoder]\n"
+        << "hq-mode = true\n"
+        << "[reverb]\n"
+        << "boost = 0\n";
+    return conf.str();
+}
+
+[[maybe_unused]] auto *const gGoldenEnv = ::testing::AddGlobalTestEnvironment(
+    new AlConfEnvironment{std::string{"golden-"} + GOLDEN_CPU_LEVEL, MakeConfig()});
+
+
+/* Generates a looping test signal with integer math only, so the source data
+ * is the same everywhere.
+ */
+enum class Wave { Saw, Triangle, Square, Noise };
+
+std::vector<ALshort> MakeWave(Wave wave, int period, int amplitude, size_t length)
+{
+    std::vector<ALshort> data(length);
+    uint32_t seed{12345u};
+    for(size_t i{0};i < length;++i)
+    {
+        const int phase{static_cast<int>(i % static_cast<size_t>(period))};
+        int value{};
+        switch(wave)
+        {
+        case Wave::Saw:
+            value = (phase*2 - period) * amplitude / period;
+            break;
+        case Wave::Triangle:
+            value = (std::abs(phase*4 - period*2) - period) * amplitude / period;
+            break;
+        case Wave::Square:
+            value = (phase < period/2) ? amplitude : -amplitude;
+            break;
+        case Wave::Noise:
+            seed = seed*1664525u + 1013904223u;
+            value = static_cast<int>(seed>>16) - 32768;
+            value = value * amplitude / 32768;
+            break;
+        }
+        data[i] = static_cast<ALshort>(value);
+    }
+    return data;
+}
+
+ALuint MakeMonoBuffer(Wave wave, int period, int amplitude)
+{
+    const auto data = MakeWave(wave, period, amplitude, 22050);
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO16, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(ALshort)), 44100);
+    return buffer;
+}
+
+ALuint MakeMultiBuffer(ALenum format, const std::vector<std::vector<ALshort>> &channels)
+{
+    const size_t length{channels.front().size()};
+    std::vector<ALshort> data(length * channels.size());
+    for(size_t i{0};i < length;++i)
+    {
+        for(size_t c{0};c < channels.size();++c)
+            data[i*channels.size() + c] = channels[c][i];
+    }
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, format, data.data(), static_cast<ALsizei>(data.size()*sizeof(ALshort)),
+        44100);
+    return buffer;
+}
+
+/* Points around the listener, as exact values. */
+constexpr std::array<std::array<float,2>,8> Ring{{
+    {{ 0.0f, -1.0f}}, {{ 0.75f, -0.75f}}, {{ 1.0f,  0.0f}}, {{ 0.75f,  0.75f}},
+    {{ 0.0f,  1.0f}}, {{-0.75f,  0.75f}}, {{-1.0f,  0.0f}}, {{-0.75f, -0.75f}},
+}};
+
+/* Moves the source along the ring, starting from the given point and going
+ * one point further over the length of the scene.
+ */
+void MoveOnRing(ALuint source, size_t start, int chunk, float radius, float height)
+{
+    const auto &a = Ring[start % Ring.size()];
+    const auto &b = Ring[(start+1) % Ring.size()];
+    const float t{static_cast<float>(chunk) / static_cast<float>(NumChunks)};
+    alSource3f(source, AL_POSITION, (a[0] + (b[0]-a[0])*t) * radius, height,
+        (a[1] + (b[1]-a[1])*t) * radius);
+}
+
+
+class SceneRenderer {
+    ALCdevice *mDevice{};
+    ALCint mNumChannels{};
+    LPALCRENDERSAMPLESSOFT mRenderSamples{};
+    std::vector<ALshort> mSamples;
+
+public:
+    SceneRenderer(ALCdevice *device, ALCint numchans, LPALCRENDERSAMPLESSOFT render)
+        : mDevice{device}, mNumChannels{numchans}, mRenderSamples{render}
+    { mSamples.reserve(static_cast<size_t>(SceneFrames) * static_cast<size_t>(numchans)); }
+
+    void render()
+    {
+        const size_t offset{mSamples.size()};
+        mSamples.resize(offset + static_cast<size_t>(ChunkFrames*mNumChannels));
+        mRenderSamples(mDevice, mSamples.data()+offset, ChunkFrames);
+    }
+
+    std::vector<ALshort> &samples() noexcept { return mSamples; }
+};
+
+
+/* Eight sources, each with a different resampler, moving around the listener
+ * while changing pitch and gain.
+ */
+void SceneMotion(SceneRenderer &renderer)
+{
+    const std::array buffers{
+        MakeMonoBuffer(Wave::Saw, 97, 12000),
+        MakeMonoBuffer(Wave::Triangle, 211, 16000),
+        MakeMonoBuffer(Wave::Square, 53, 8000),
+        MakeMonoBuffer(Wave::Noise, 1, 8000),
+    };
+    const ALint numresamplers{alGetInteger(AL_NUM_RESAMPLERS_SOFT)};
+
+    std::array<ALuint,8> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    for(size_t i{0};i < sources.size();++i)
+    {
+        alSourcei(sources[i], AL_BUFFER, static_cast<ALint>(buffers[i%buffers.size()]));
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSourcei(sources[i], AL_SOURCE_RESAMPLER_SOFT, static_cast<ALint>(i)%numresamplers);
+        alSourcef(sources[i], AL_GAIN, 0.25f);
+    }
+
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    alFilterf(filter, AL_LOWPASS_GAIN, 0.75f);
+    alFilterf(filter, AL_LOWPASS_GAINHF, 0.25f);
+    alSourcei(sources[1], AL_DIRECT_FILTER, static_cast<ALint>(filter));
+    alSource3f(sources[2], AL_VELOCITY, 0.0f, 0.0f, 40.0f);
+
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        for(size_t i{0};i < sources.size();++i)
+        {
+            MoveOnRing(sources[i], i, chunk, 2.0f, 0.0f);
+            alSourcef(sources[i], AL_PITCH,
+                0.5f + 0.25f*static_cast<float>((static_cast<size_t>(chunk)+i) % 8));
+            if((chunk%4) == 0)
+                alSourcef(sources[i], AL_GAIN, 0.125f + 0.0625f*static_cast<float>((chunk/4)%3));
+        }
+        renderer.render();
+    }
+}
+
+/* Sources sent through reverb, chorus, echo, and ring modulator slots, with
+ * UHJ output.
+ */
+void SceneEffects(SceneRenderer &renderer)
+{
+    const std::array buffers{
+        MakeMonoBuffer(Wave::Saw, 131, 12000),
+        MakeMonoBuffer(Wave::Noise, 1, 6000),
+        MakeMonoBuffer(Wave::Square, 71, 8000),
+    };
+
+    const std::array types{AL_EFFECT_EAXREVERB, AL_EFFECT_CHORUS, AL_EFFECT_ECHO,
+        AL_EFFECT_RING_MODULATOR};
+    std::array<ALuint,types.size()> effects{};
+    std::array<ALuint,types.size()> slots{};
+    alGenEffects(static_cast<ALsizei>(effects.size()), effects.data());
+    alGenAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+    for(size_t i{0};i < types.size();++i)
+    {
+        alEffecti(effects[i], AL_EFFECT_TYPE, types[i]);
+        alAuxiliaryEffectSloti(slots[i], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effects[i]));
+    }
+
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    alFilterf(filter, AL_LOWPASS_GAIN, 1.0f);
+    alFilterf(filter, AL_LOWPASS_GAINHF, 0.5f);
+
+    std::array<ALuint,buffers.size()> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    for(size_t i{0};i < sources.size();++i)
+    {
+        alSourcei(sources[i], AL_BUFFER, static_cast<ALint>(buffers[i]));
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSourcef(sources[i], AL_GAIN, 0.5f);
+    }
+    alSource3i(sources[0], AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[0]), 0,
+        AL_FILTER_NULL);
+    alSource3i(sources[0], AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[1]), 1,
+        AL_FILTER_NULL);
+    alSource3i(sources[1], AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[2]), 0,
+        AL_FILTER_NULL);
+    alSource3i(sources[2], AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[3]), 0,
+        static_cast<ALint>(filter));
+
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        for(size_t i{0};i < sources.size();++i)
+            MoveOnRing(sources[i], i*3, chunk, 1.5f, 0.0f);
+        if(chunk == NumChunks/2)
+        {
+            /* Change some parameters part way, and cut a source to leave the
+             * effect tails.
+             */
+            alEffectf(effects[1], AL_CHORUS_RATE, 4.0f);
+            alAuxiliaryEffectSloti(slots[1], AL_EFFECTSLOT_EFFECT,
+                static_cast<ALint>(effects[1]));
+            alAuxiliaryEffectSlotf(slots[0], AL_EFFECTSLOT_GAIN, 0.5f);
+            alSourceStop(sources[1]);
+        }
+        renderer.render();
+    }
+}
+
+/* Effect slots feeding another slot, with stereo output. The second level's
+ * slot takes a wet buffer with more channels than the dry mix, which the first
+ * level's effects output to.
+ */
+void SceneEffectChain(SceneRenderer &renderer)
+{
+    const ALuint buffer{MakeMonoBuffer(Wave::Noise, 1, 8000)};
+
+    const std::array types{AL_EFFECT_REVERB, AL_EFFECT_ECHO, AL_EFFECT_CHORUS};
+    std::array<ALuint,types.size()> effects{};
+    std::array<ALuint,types.size()> slots{};
+    alGenEffects(static_cast<ALsizei>(effects.size()), effects.data());
+    alGenAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+    for(size_t i{0};i < types.size();++i)
+    {
+        alEffecti(effects[i], AL_EFFECT_TYPE, types[i]);
+        alAuxiliaryEffectSloti(slots[i], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effects[i]));
+    }
+    alAuxiliaryEffectSloti(slots[0], AL_EFFECTSLOT_TARGET_SOFT, static_cast<ALint>(slots[2]));
+
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+    alSourcei(source, AL_LOOPING, AL_TRUE);
+    alSourcef(source, AL_GAIN, 0.5f);
+    alSource3i(source, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[0]), 0,
+        AL_FILTER_NULL);
+    alSource3i(source, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slots[1]), 1,
+        AL_FILTER_NULL);
+
+    alSourcePlay(source);
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        MoveOnRing(source, 1, chunk, 1.0f, 0.0f);
+        /* Stop the source halfway through, so the rest is the effects' tails. */
+        if(chunk == NumChunks/2)
+            alSourceStop(source);
+        renderer.render();
+    }
+}
+
+/* Sources circling the listener at different heights, with HRTF output. */
+void SceneHrtf(SceneRenderer &renderer)
+{
+    const std::array buffers{
+        MakeMonoBuffer(Wave::Noise, 1, 8000),
+        MakeMonoBuffer(Wave::Saw, 89, 12000),
+        MakeMonoBuffer(Wave::Triangle, 151, 16000),
+    };
+
+    std::array<ALuint,buffers.size()> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    for(size_t i{0};i < sources.size();++i)
+    {
+        alSourcei(sources[i], AL_BUFFER, static_cast<ALint>(buffers[i]));
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSourcef(sources[i], AL_GAIN, 0.5f);
+    }
+    alSourcei(sources[2], AL_SOURCE_RELATIVE, AL_TRUE);
+
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        MoveOnRing(sources[0], 0, chunk, 1.0f, 0.5f);
+        MoveOnRing(sources[1], 3, chunk, 2.0f, -1.0f);
+        MoveOnRing(sources[2], 6, chunk, 0.5f, 0.0f);
+        renderer.render();
+    }
+}
+
+/* A B-Format source and a mono source decoded to 5.1, with the listener
+ * turning.
+ */
+void SceneSurround(SceneRenderer &renderer)
+{
+    const ALuint bformat{MakeMultiBuffer(AL_FORMAT_BFORMAT3D_16, {
+        MakeWave(Wave::Noise, 1, 6000, 22050),
+        MakeWave(Wave::Saw, 113, 8000, 22050),
+        MakeWave(Wave::Triangle, 173, 8000, 22050),
+        MakeWave(Wave::Square, 67, 4000, 22050)})};
+    const ALuint mono{MakeMonoBuffer(Wave::Saw, 101, 12000)};
+
+    std::array<ALuint,2> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    alSourcei(sources[0], AL_BUFFER, static_cast<ALint>(bformat));
+    alSourcei(sources[1], AL_BUFFER, static_cast<ALint>(mono));
+    for(const ALuint source : sources)
+    {
+        alSourcei(source, AL_LOOPING, AL_TRUE);
+        alSourcef(source, AL_GAIN, 0.5f);
+    }
+
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        MoveOnRing(sources[1], 2, chunk, 2.0f, 0.0f);
+
+        const auto &a = Ring[static_cast<size_t>(chunk/8) % Ring.size()];
+        const std::array<ALfloat,6> orient{a[0], 0.0f, a[1], 0.0f, 1.0f, 0.0f};
+        alListenerfv(AL_ORIENTATION, orient.data());
+        renderer.render();
+    }
+}
+
+/* Mono and stereo sources rendered to first-order ambisonics. */
+void SceneAmbisonic(SceneRenderer &renderer)
+{
+    const ALuint stereo{MakeMultiBuffer(AL_FORMAT_STEREO16, {
+        MakeWave(Wave::Saw, 127, 10000, 22050),
+        MakeWave(Wave::Square, 79, 6000, 22050)})};
+    const ALuint mono{MakeMonoBuffer(Wave::Triangle, 59, 16000)};
+
+    std::array<ALuint,2> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    alSourcei(sources[0], AL_BUFFER, static_cast<ALint>(stereo));
+    alSourcei(sources[1], AL_BUFFER, static_cast<ALint>(mono));
+    for(const ALuint source : sources)
+    {
+        alSourcei(source, AL_LOOPING, AL_TRUE);
+        alSourcef(source, AL_GAIN, 0.5f);
+    }
+
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    for(int chunk{0};chunk < NumChunks;++chunk)
+    {
+        const float spread{0.25f + 0.03125f*static_cast<float>(chunk%16)};
+        const std::array<ALfloat,2> angles{spread, -spread};
+        alSourcefv(sources[0], AL_STEREO_ANGLES, angles.data());
+        MoveOnRing(sources[1], 5, chunk, 1.0f, 0.25f);
+        renderer.render();
+    }
+}
+
+
+struct Scene {
+    const char *name;
+    ALCenum channels;
+    ALCint numChannels;
+    /* Extra context attributes, zero-terminated. */
+    std::array<ALCint,9> attrs;
+    void (*script)(SceneRenderer&);
+};
+
+const std::array Scenes{
+    Scene{"motion", ALC_STEREO_SOFT, 2, {ALC_OUTPUT_MODE_SOFT, ALC_STEREO_BASIC_SOFT, 0},
+        SceneMotion},
+    Scene{"effects", ALC_STEREO_SOFT, 2, {ALC_OUTPUT_MODE_SOFT, ALC_STEREO_UHJ_SOFT,
+        ALC_MAX_AUXILIARY_SENDS, 2, 0}, SceneEffects},
+    Scene{"effectchain", ALC_STEREO_SOFT, 2, {ALC_OUTPUT_MODE_SOFT, ALC_STEREO_BASIC_SOFT,
+        ALC_MAX_AUXILIARY_SENDS, 2, 0}, SceneEffectChain},
+    Scene{"hrtf", ALC_STEREO_SOFT, 2, {ALC_OUTPUT_MODE_SOFT, ALC_STEREO_HRTF_SOFT,
+        ALC_HRTF_SOFT, ALC_TRUE, 0}, SceneHrtf},
+    Scene{"surround51", ALC_5POINT1_SOFT, 6, {ALC_OUTPUT_MODE_SOFT, ALC_SURROUND_5_1_SOFT, 0},
+        SceneSurround},
+    Scene{"ambisonic", ALC_BFORMAT3D_SOFT, 4, {ALC_AMBISONIC_LAYOUT_SOFT, ALC_ACN_SOFT,
+        ALC_AMBISONIC_SCALING_SOFT, ALC_SN3D_SOFT, ALC_AMBISONIC_ORDER_SOFT, 1, 0},
+        SceneAmbisonic},
+};
+
+
+/* Reference files are a text header line followed by the 16-bit samples in
+ * little-endian order.
+ */
+struct Reference {
+    std::string arch;
+    ALCint numChannels{};
+    ALCsizei numFrames{};
+    std::vector<ALshort> samples;
+};
+
+std::filesystem::path ReferencePath(const Scene &scene)
+{ return std::filesystem::path{GOLDEN_DATA_DIR} / (std::string{scene.name} + ".ref"); }
+
+bool WriteReference(const std::filesystem::path &path, const Scene &scene,
+    const std::vector<ALshort> &samples)
+{
+    std::ofstream file{path, std::ios::binary};
+    file<< "openal-soft-golden 1 " << GoldenArch << " " << scene.numChannels << " "
+        << SceneFrames << "\n";
+    for(const ALshort sample : samples)
+    {
+        const auto value = static_cast<uint16_t>(sample);
+        file.put(static_cast<char>(value&0xff));
+        file.put(static_cast<char>(value>>8));
+    }
+    return file.good();
+}
+
+bool ReadReference(const std::filesystem::path &path, Reference &ref)
+{
+    std::ifstream file{path, std::ios::binary};
+    std::string magic;
+    int version{};
+    file >> magic >> version >> ref.arch >> ref.numChannels >> ref.numFrames;
+    if(!file || magic != "openal-soft-golden" || version != 1 || file.get() != '\n')
+        return false;
+
+    ref.samples.resize(static_cast<size_t>(ref.numFrames) * static_cast<size_t>(ref.numChannels));
+    for(ALshort &sample : ref.samples)
+    {
+        const int lo{file.get()};
+        const int hi{file.get()};
+        sample = static_cast<ALshort>(static_cast<uint16_t>((lo&0xff) | ((hi&0xff)<<8)));
+    }
+    return file.good();
+}
+
+double GetMinSnr()
+{
+    if(const char *str{std::getenv("ALSOFT_GOLDEN_MIN_SNR")})
+        return std::strtod(str, nullptr);
+    return DefaultMinSnr;
+}
+
+bool WantExact()
+{
+    const char *str{std::getenv("ALSOFT_GOLDEN_EXACT")};
+    return !str || std::strtol(str, nullptr, 10) != 0;
+}
+
+
+class LoopbackGoldenTest : public ::testing::TestWithParam<size_t> {
+};
+
+TEST_P(LoopbackGoldenTest, MatchesReference)
+{
+    const Scene &scene = Scenes[GetParam()];
+    const CpuLevel *level{GetTestLevel()};
+    ASSERT_NE(level, nullptr);
+
+    if(!level->supported())
+        GTEST_SKIP() << "CPU level " << level->name << " is not supported";
+
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+        GTEST_SKIP() << "ALC_SOFT_loopback not supported";
+    auto loopbackOpenDevice = reinterpret_cast<LPALCLOOPBACKOPENDEVICESOFT>(
+        alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT"));
+    auto renderSamples = reinterpret_cast<LPALCRENDERSAMPLESSOFT>(
+        alcGetProcAddress(nullptr, "alcRenderSamplesSOFT"));
+
+    ALCdevice *device{loopbackOpenDevice(nullptr)};
+    ASSERT_NE(device, nullptr);
+
+    std::vector<ALCint> attrs{ALC_FREQUENCY, GoldenRate, ALC_FORMAT_CHANNELS_SOFT, scene.channels,
+        ALC_FORMAT_TYPE_SOFT, ALC_SHORT_SOFT};
+    for(size_t i{0};scene.attrs[i] != 0;i += 2)
+    {
+        attrs.emplace_back(scene.attrs[i]);
+        attrs.emplace_back(scene.attrs[i+1]);
+    }
+    attrs.emplace_back(0);
+
+    ALCcontext *context{alcCreateContext(device, attrs.data())};
+    if(!context || !alcMakeContextCurrent(context))
+    {
+        if(context)
+            alcDestroyContext(context);
+        alcCloseDevice(device);
+        FAIL() << "Failed to create context for scene " << scene.name;
+    }
+
+    SceneRenderer renderer{device, scene.numChannels, renderSamples};
+    scene.script(renderer);
+    const ALenum err{alGetError()};
+
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    ASSERT_EQ(err, AL_NO_ERROR) << "AL error while rendering scene " << scene.name;
+    const auto &samples = renderer.samples();
+
+    const auto refpath = ReferencePath(scene);
+    if(const char *update{std::getenv("ALSOFT_GOLDEN_UPDATE")};
+        update && std::strtol(update, nullptr, 10) != 0)
+    {
+        if(level->name != std::string_view{"c"} || EffectThreads > 0)
+            GTEST_SKIP() << "References are only written from the serial C level";
+        ASSERT_TRUE(WriteReference(refpath, scene, samples)) << "Failed to write " << refpath;
+        GTEST_SKIP() << "Wrote " << refpath;
+    }
+
+    Reference ref;
+    ASSERT_TRUE(ReadReference(refpath, ref)) << "Failed to read " << refpath;
+    ASSERT_EQ(ref.numChannels, scene.numChannels);
+    ASSERT_EQ(ref.numFrames, SceneFrames);
+
+    if(level->name == std::string_view{"c"} && EffectThreads == 0 && ref.arch == GoldenArch
+        && WantExact())
+    {
+        const auto mismatch = std::mismatch(samples.cbegin(), samples.cend(),
+            ref.samples.cbegin());
+        EXPECT_TRUE(mismatch.first == samples.cend())
+            << "Scene " << scene.name << " differs from the reference at frame "
+            << (mismatch.first - samples.cbegin()) / scene.numChannels << ", channel "
+            << (mismatch.first - samples.cbegin()) % scene.numChannels;
+        return;
+    }
+
+    double signal{0.0}, noise{0.0};
+    for(size_t i{0};i < samples.size();++i)
+    {
+        const auto refval = static_cast<double>(ref.samples[i]);
+        const double diff{static_cast<double>(samples[i]) - refval};
+        signal += refval * refval;
+        noise += diff * diff;
+    }
+    const double snr{(noise > 0.0) ? 10.0*std::log10(signal / noise)
+        : std::numeric_limits<double>::infinity()};
+    EXPECT_GE(snr, GetMinSnr()) << "Scene " << scene.name << " at CPU level " << level->name
+        << " is too far from the reference";
+}
+
+std::string TestName(const ::testing::TestParamInfo<LoopbackGoldenTest::ParamType> &info)
+{ return std::string{Scenes[info.param].name}; }
+
+INSTANTIATE_TEST_SUITE_P(Golden, LoopbackGoldenTest, ::testing::Range(size_t{0}, Scenes.size()),
+    TestName);
+
+} // namespace
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+/* Renders out-of-range and NaN samples through a stereo loopback device, to
+ * check the interleaved output conversion for each sample type.
+ */
+
+namespace {
+
+constexpr ALCint TestRate{48000};
+constexpr ALCsizei TestFrames{1024};
+
+struct ConversionParam {
+    const char *name;
+    ALCenum type;
+    /* The expected output for NaN, full-scale positive, and full-scale
+     * negative input.
+     */
+    int64_t nan, max, min;
+};
+
+class OutputConversionTest : public ::testing::TestWithParam<ConversionParam> {
+};
+
+auto SampleSize(ALCenum type) -> size_t
+{
+    switch(type)
+    {
+    case ALC_BYTE_SOFT: case ALC_UNSIGNED_BYTE_SOFT: return 1;
+    case ALC_SHORT_SOFT: case ALC_UNSIGNED_SHORT_SOFT: return 2;
+    }
+    return 4;
+}
+
+template<typename T>
+auto ReadSamples(const std::vector<unsigned char> &data) -> std::vector<int64_t>
+{
+    std::vector<int64_t> ret(data.size() / sizeof(T));
+    for(size_t i{0};i < ret.size();++i)
+    {
+        T sample{};
+        std::memcpy(&sample, &data[i*sizeof(T)], sizeof(T));
+        ret[i] = sample;
+    }
+    return ret;
+}
+
+TEST_P(OutputConversionTest, ClampsAndHandlesNaN)
+{
+    const ConversionParam &param = GetParam();
+
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+        GTEST_SKIP() << "ALC_SOFT_loopback not supported";
+
+    ALCdevice *device{alcLoopbackOpenDeviceSOFT(nullptr)};
+    ASSERT_NE(device, nullptr);
+
+    /* The limiter would scale the whole output, so it's disabled to let the
+     * samples reach the conversion as they are.
+     */
+    const std::array<ALCint,9> attrs{{ALC_FREQUENCY, TestRate, ALC_FORMAT_CHANNELS_SOFT,
+        ALC_STEREO_SOFT, ALC_FORMAT_TYPE_SOFT, param.type, ALC_OUTPUT_LIMITER_SOFT, ALC_FALSE,
+        0}};
+    ALCcontext *context{alcCreateContext(device, attrs.data())};
+    if(!context || !alcMakeContextCurrent(context))
+    {
+        if(context)
+            alcDestroyContext(context);
+        alcCloseDevice(device);
+        FAIL() << "Failed to create context";
+    }
+
+    /* Each frame has NaN on the left, and alternates between over- and
+     * under-range samples on the right.
+     */
+    std::vector<float> data(static_cast<size_t>(TestFrames) * 4 * 2);
+    for(size_t i{0};i < data.size()/2;++i)
+    {
+        data[i*2 + 0] = std::numeric_limits<float>::quiet_NaN();
+        data[i*2 + 1] = (i&1) ? -2.0f : 2.0f;
+    }
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_STEREO_FLOAT32, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), TestRate);
+
+    ALuint source{};
+    alGenSources(1, &source);
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+    alSourcei(source, AL_DIRECT_CHANNELS_SOFT, AL_TRUE);
+    alSourcePlay(source);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* Skip the first block, where the source fades in. */
+    const size_t framesize{2 * SampleSize(param.type)};
+    std::vector<unsigned char> output(framesize * TestFrames);
+    alcRenderSamplesSOFT(device, output.data(), TestFrames);
+    alcRenderSamplesSOFT(device, output.data(), TestFrames);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffer);
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    std::vector<int64_t> samples;
+    switch(param.type)
+    {
+    case ALC_BYTE_SOFT: samples = ReadSamples<int8_t>(output); break;
+    case ALC_UNSIGNED_BYTE_SOFT: samples = ReadSamples<uint8_t>(output); break;
+    case ALC_SHORT_SOFT: samples = ReadSamples<int16_t>(output); break;
+    case ALC_UNSIGNED_SHORT_SOFT: samples = ReadSamples<uint16_t>(output); break;
+    case ALC_INT_SOFT: samples = ReadSamples<int32_t>(output); break;
+    case ALC_UNSIGNED_INT_SOFT: samples = ReadSamples<uint32_t>(output); break;
+    }
+    ASSERT_EQ(samples.size(), static_cast<size_t>(TestFrames) * 2);
+
+    for(size_t i{0};i < TestFrames;++i)
+    {
+        ASSERT_EQ(samples[i*2 + 0], param.nan) << "NaN at frame " << i;
+        ASSERT_EQ(samples[i*2 + 1], (i&1) ? param.min : param.max)
+            << "Out of range sample at frame " << i;
+    }
+}
+
+/* NaN converts the same as with a scalar float-to-int conversion: INT_MIN for
+ * 32-bit output, which truncates to 0 for narrower types.
+ */
+INSTANTIATE_TEST_SUITE_P(Output, OutputConversionTest, ::testing::Values(
+    ConversionParam{"byte", ALC_BYTE_SOFT, 0, 127, -128},
+    ConversionParam{"ubyte", ALC_UNSIGNED_BYTE_SOFT, 128, 255, 0},
+    ConversionParam{"short", ALC_SHORT_SOFT, 0, 32767, -32768},
+    ConversionParam{"ushort", ALC_UNSIGNED_SHORT_SOFT, 32768, 65535, 0},
+    ConversionParam{"int", ALC_INT_SOFT, std::numeric_limits<int32_t>::min(), 2147483520,
+        std::numeric_limits<int32_t>::min()},
+    ConversionParam{"uint", ALC_UNSIGNED_INT_SOFT, 0, 4294967168, 0}),
+    [](const ::testing::TestParamInfo<ConversionParam> &info) { return info.param.name; });
+
+} // namespace
@@ -0,0 +1,994 @@
+/*
+ * OpenAL Soft Benchmark Suite
+ *
+ * Copyright (c) 2026 by the OpenAL Soft contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This runs the mixer's DSP kernels directly, as well as full mixing passes
+ * through a loopback device, and writes the results as JSON so they can be
+ * compared between builds. The program is built with the library's own object
+ * files, so the kernels and the loopback device come from the same build, with
+ * the loopback tests going through the normal API. The loopback tests cover
+ * the interleaved and planar render calls, the mixing block size, and the
+ * effect and post-process stages, and can print the mixer's per-stage timing
+ * profile for each case.
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "AL/alext.h"
+#include "AL/efx.h"
+
+#include "alc/inprogext.h"
+#include "alcomplex.h"
+#include "alnumbers.h"
+#include "alnumeric.h"
+#include "alspan.h"
+#include "alstring.h"
+#include "core/bs2b.h"
+#include "core/bufferline.h"
+#include "core/cpu_caps.h"
+#include "core/filters/biquad.h"
+#include "core/mixer/defs.h"
+#include "core/mixer/hrtfdefs.h"
+#include "core/resampler_limits.h"
+#include "core/uhjfilter.h"
+
+#include "win_main_utf8.h"
+
+
+struct CTag;
+#ifdef HAVE_SSE
+struct SSETag;
+#endif
+#ifdef HAVE_NEON
+struct NEONTag;
+#endif
+
+namespace {
+
+using namespace std::string_view_literals;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using clock_type = std::chrono::steady_clock;
+
+using uint = unsigned int;
+
+using MixFunc = void(*)(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, const al::span<float> CurrentGains,
+    const al::span<const float> TargetGains, const size_t Counter, const size_t OutPos);
+using HrtfFunc = void(*)(const al::span<const float> InSamples,
+    const al::span<float2> AccumSamples, const uint IrSize, const MixHrtfFilter *hrtfparams,
+    const size_t SamplesToDo);
+
+constexpr uint BenchRate{48000};
+
+
+/* A CPU feature level to run the kernels with. The resamplers are selected
+ * through CPUCapFlags, so they're run for every level. The mixers only have
+ * one vectorized variant each, so they're only run for the levels that have
+ * one.
+ */
+struct CpuLevel {
+    const char *name;
+    int caps;
+    MixFunc mix;
+    HrtfFunc hrtf;
+};
+
+auto GetCpuLevels() -> std::vector<CpuLevel>
+{
+    std::vector<CpuLevel> levels;
+    levels.emplace_back(CpuLevel{"c", 0, Mix_<CTag>, MixHrtf_<CTag>});
+
+    const auto cpuinfo = GetCPUInfo();
+    const int caps{cpuinfo ? cpuinfo->mCaps : 0};
+#ifdef HAVE_SSE
+    if((caps&CPU_CAP_SSE))
+        levels.emplace_back(CpuLevel{"sse", CPU_CAP_SSE, Mix_<SSETag>, MixHrtf_<SSETag>});
+#endif
+#ifdef HAVE_SSE2
+    if((caps&CPU_CAP_SSE2))
+        levels.emplace_back(CpuLevel{"sse2", CPU_CAP_SSE|CPU_CAP_SSE2, nullptr, nullptr});
+#endif
+#ifdef HAVE_SSE4_1
+    if((caps&CPU_CAP_SSE4_1))
+        levels.emplace_back(CpuLevel{"sse4.1", CPU_CAP_SSE|CPU_CAP_SSE2|CPU_CAP_SSE3|CPU_CAP_SSE4_1,
+            nullptr, nullptr});
+#endif
+#ifdef HAVE_NEON
+    if((caps&CPU_CAP_NEON))
+        levels.emplace_back(CpuLevel{"neon", CPU_CAP_NEON, Mix_<NEONTag>, MixHrtf_<NEONTag>});
+#endif
+    return levels;
+}
+
+
+struct Param {
+    std::string_view name;
+    double value;
+};
+
+/* Suite, kernel, and SIMD names all refer to string literals. */
+struct Result {
+    std::string_view suite;
+    std::string_view name;
+    std::string_view simd;
+    std::vector<Param> params;
+    double nsPerSample;
+    double realtime; /* Only for loopback results. */
+};
+
+
+struct Options {
+    double kernelTime{0.1}; /* Seconds of wall time for each kernel case. */
+    uint renderSeconds{4}; /* Seconds of audio for each loopback case. */
+    std::vector<uint> voiceCounts{16, 64, 256};
+    bool profile{false}; /* Print the mixer's stage timings for loopback cases. */
+    std::vector<std::string> filters;
+    std::string output;
+};
+
+Options gOptions;
+std::vector<Result> gResults;
+
+
+auto Selected(std::string_view suite, std::string_view name) -> bool
+{
+    if(gOptions.filters.empty())
+        return true;
+
+    std::string fullname{suite};
+    fullname += '/';
+    fullname += name;
+    return std::any_of(gOptions.filters.cbegin(), gOptions.filters.cend(),
+        [&fullname](const std::string &filter) -> bool
+        { return fullname.find(filter) != std::string::npos; });
+}
+
+/* Runs the given function repeatedly for at least the configured time, and
+ * returns the average number of nanoseconds each call took.
+ */
+template<typename F>
+auto TimeKernel(F&& func) -> double
+{
+    /* Warm up the caches and branch predictors first. */
+    for(size_t i{0};i < 16;++i)
+        func();
+
+    const auto target = duration_cast<nanoseconds>(std::chrono::duration<double>{
+        gOptions.kernelTime});
+    size_t iters{64};
+    while(true)
+    {
+        const auto start = clock_type::now();
+        for(size_t i{0};i < iters;++i)
+            func();
+        const auto elapsed = clock_type::now() - start;
+        if(elapsed >= target || iters >= (size_t{1}<<30))
+            return static_cast<double>(duration_cast<nanoseconds>(elapsed).count())
+                / static_cast<double>(iters);
+
+        /* Scale up to (a bit past) the target time, at most 16x per try. */
+        const auto count = std::max<int64_t>(duration_cast<nanoseconds>(elapsed).count(), 1);
+        const auto scale = std::clamp<double>(static_cast<double>(target.count())*1.1
+            / static_cast<double>(count), 2.0, 16.0);
+        iters = static_cast<size_t>(static_cast<double>(iters) * scale);
+    }
+}
+
+void AddKernelResult(std::string_view suite, std::string_view name, std::string_view simd,
+    std::vector<Param> params, double nsPerCall, size_t samplesPerCall)
+{
+    const double nspersample{nsPerCall / static_cast<double>(samplesPerCall)};
+    fprintf(stderr, "  %.*s/%.*s", al::sizei(suite), suite.data(), al::sizei(name),
+        name.data());
+    if(!simd.empty())
+        fprintf(stderr, " [%.*s]", al::sizei(simd), simd.data());
+    fprintf(stderr, ":");
+    for(const auto &param : params)
+        fprintf(stderr, " %.*s=%g", al::sizei(param.name), param.name.data(), param.value);
+    fprintf(stderr, " - %.3f ns/sample\n", nspersample);
+
+    gResults.emplace_back(Result{suite, name, simd,
+        std::move(params), nspersample, 0.0});
+}
+
+
+/* Fills the span with a noisy signal, to avoid any special-casing for silence
+ * or denormals.
+ */
+void FillNoise(const al::span<float> data)
+{
+    uint seed{22222u};
+    std::generate(data.begin(), data.end(), [&seed]()
+    {
+        seed = seed*96314165u + 907633515u;
+        return static_cast<float>(static_cast<int>(seed>>8) - (1<<23)) / float{1<<24};
+    });
+}
+
+
+void BenchResamplers(const al::span<const CpuLevel> levels)
+{
+    static constexpr std::array resamplers{
+        std::make_pair(Resampler::Point, "point"sv),
+        std::make_pair(Resampler::Linear, "linear"sv),
+        std::make_pair(Resampler::Spline, "spline"sv),
+        std::make_pair(Resampler::Gaussian, "gaussian"sv),
+        std::make_pair(Resampler::FastBSinc12, "fast_bsinc12"sv),
+        std::make_pair(Resampler::BSinc12, "bsinc12"sv),
+        std::make_pair(Resampler::FastBSinc24, "fast_bsinc24"sv),
+        std::make_pair(Resampler::BSinc24, "bsinc24"sv),
+    };
+    static constexpr std::array pitches{0.5, 1.0, 1.5, 2.5};
+    static constexpr size_t DstSize{BufferLineSize};
+
+    auto src = std::vector<float>(MaxResamplerPadding
+        + static_cast<size_t>(std::ceil(DstSize*pitches.back())) + 1);
+    FillNoise(src);
+    auto dst = std::vector<float>(DstSize);
+
+    for(const auto &[resampler, name] : resamplers)
+    {
+        if(!Selected("resample"sv, name))
+            continue;
+        for(const auto &level : levels)
+        {
+            CPUCapFlags = level.caps;
+            for(const double pitch : pitches)
+            {
+                const auto increment = static_cast<uint>(pitch*MixerFracOne);
+                InterpState state{};
+                const ResamplerFunc func{PrepareResampler(resampler, increment, &state)};
+                const double ns{TimeKernel([&]{ func(&state, src, 0, increment, dst); })};
+                AddKernelResult("resample"sv, name, level.name, {{"pitch"sv, pitch}}, ns,
+                    DstSize);
+            }
+        }
+    }
+}
+
+void BenchMixers(const al::span<const CpuLevel> levels)
+{
+    static constexpr std::array channelCounts{1u, 2u, 4u, 6u, 8u, 16u};
+    static constexpr size_t NumSamples{BufferLineSize};
+
+    auto input = std::vector<float>(NumSamples);
+    FillNoise(input);
+    auto output = std::vector<FloatBufferLine>(channelCounts.back());
+    auto current = std::vector<float>(channelCounts.back());
+    auto target = std::vector<float>(channelCounts.back());
+
+    /* Steady gains take the fast path, while fading gains are what happens
+     * when a voice starts or its parameters change.
+     */
+    for(const auto &[name, fading] : {std::make_pair("mix_steady"sv, false),
+        std::make_pair("mix_fading"sv, true)})
+    {
+        if(!Selected("mix"sv, name))
+            continue;
+        for(const auto &level : levels)
+        {
+            if(!level.mix)
+                continue;
+            for(const uint chans : channelCounts)
+            {
+                auto outspan = al::span{output}.first(chans);
+                const double ns{TimeKernel([&]
+                {
+                    std::fill(current.begin(), current.end(), 0.25f);
+                    std::fill(target.begin(), target.end(), fading ? 0.75f : 0.25f);
+                    level.mix(input, outspan, current, target, fading ? NumSamples : 0, 0);
+                })};
+                AddKernelResult("mix"sv, name, level.name,
+                    {{"channels"sv, static_cast<double>(chans)}}, ns, NumSamples);
+            }
+        }
+    }
+}
+
+void BenchHrtf(const al::span<const CpuLevel> levels)
+{
+    static constexpr std::array irSizes{MinIrLength, 16u, 32u, 64u, HrirLength};
+    static constexpr size_t NumSamples{BufferLineSize};
+
+    if(!Selected("hrtf"sv, "mix_hrtf"sv))
+        return;
+
+    auto input = std::vector<float>(HrtfHistoryLength + NumSamples);
+    FillNoise(input);
+    auto accum = std::vector<float2>(NumSamples + HrirLength);
+
+    alignas(16) HrirArray coeffs{};
+    FillNoise(al::span{coeffs.front().data(), coeffs.size()*2});
+    const MixHrtfFilter params{coeffs, {{4, 12}}, 0.5f, 0.0f};
+
+    for(const auto &level : levels)
+    {
+        if(!level.hrtf)
+            continue;
+        for(const uint irsize : irSizes)
+        {
+            const double ns{TimeKernel([&]
+            {
+                std::fill(accum.begin(), accum.end(), float2{});
+                level.hrtf(input, accum, irsize, &params, NumSamples);
+            })};
+            AddKernelResult("hrtf"sv, "mix_hrtf"sv, level.name,
+                {{"ir_size"sv, static_cast<double>(irsize)}}, ns, NumSamples);
+        }
+    }
+}
+
+void BenchFilters()
+{
+    struct FilterType {
+        BiquadType type;
+        std::string_view name;
+        std::string_view dualname;
+    };
+    static constexpr std::array types{
+        FilterType{BiquadType::LowPass, "lowpass"sv, "lowpass_dual"sv},
+        FilterType{BiquadType::HighPass, "highpass"sv, "highpass_dual"sv},
+        FilterType{BiquadType::Peaking, "peaking"sv, "peaking_dual"sv},
+        FilterType{BiquadType::HighShelf, "highshelf"sv, "highshelf_dual"sv},
+    };
+    static constexpr size_t NumSamples{BufferLineSize};
+
+    auto input = std::vector<float>(NumSamples);
+    FillNoise(input);
+    auto output = std::vector<float>(NumSamples);
+
+    for(const auto &[type, name, dualname] : types)
+    {
+        if(!Selected("filter"sv, name))
+            continue;
+
+        BiquadFilter filter;
+        filter.setParamsFromSlope(type, 5000.0f/BenchRate, 0.5f, 0.75f);
+        const double ns{TimeKernel([&]{ filter.process(input, output); })};
+        AddKernelResult("filter"sv, name, ""sv, {}, ns, NumSamples);
+
+        BiquadFilter filter2;
+        filter2.copyParamsFrom(filter);
+        const double dualns{TimeKernel([&]{ filter.dualProcess(filter2, input, output); })};
+        AddKernelResult("filter"sv, dualname, ""sv, {}, dualns, NumSamples);
+    }
+}
+
+/* The frequency shifter's two ways of getting an analytic signal: an FFT-based
+ * Hilbert transform over 1024 samples for every 256 input samples, or the UHJ
+ * all-pass filter pair run over each sample.
+ */
+void BenchHilbert()
+{
+    if(Selected("filter"sv, "hilbert_fir"sv))
+    {
+        static constexpr size_t HilSize{1024};
+        static constexpr size_t HilStep{HilSize / 4};
+
+        auto input = std::vector<float>(HilSize);
+        FillNoise(input);
+        auto analytic = std::vector<std::complex<double>>(HilSize);
+        const double ns{TimeKernel([&]
+        {
+            std::copy(input.cbegin(), input.cend(), analytic.begin());
+            complex_hilbert(analytic);
+        })};
+        AddKernelResult("filter"sv, "hilbert_fir"sv, ""sv, {}, ns, HilStep);
+    }
+
+    if(Selected("filter"sv, "hilbert_iir"sv))
+    {
+        static constexpr size_t NumSamples{BufferLineSize};
+
+        auto input = std::vector<float>(NumSamples);
+        FillNoise(input);
+        auto real = std::vector<float>(NumSamples);
+        auto imag = std::vector<float>(NumSamples);
+        UhjAllPassFilter filter1, filter2;
+        const double ns{TimeKernel([&]
+        {
+            filter1.process(UhjAllPass1Coeffs, input, true, real);
+            filter2.process(UhjAllPass2Coeffs, input, true, imag);
+        })};
+        AddKernelResult("filter"sv, "hilbert_iir"sv, ""sv, {}, ns, NumSamples);
+    }
+}
+
+/* BS2B and UHJ encoding are only used for non-loopback output, so they're run
+ * here directly rather than through the loopback post-process tests.
+ */
+void BenchPostProcess()
+{
+    static constexpr size_t NumSamples{BufferLineSize};
+
+    auto left = std::vector<float>(NumSamples);
+    auto right = std::vector<float>(NumSamples);
+    FillNoise(left);
+    FillNoise(right);
+
+    if(Selected("post"sv, "bs2b"sv))
+    {
+        auto bs2b = std::make_unique<Bs2b::bs2b>();
+        bs2b->set_params(Bs2b::DefaultCLevel, BenchRate);
+        const double ns{TimeKernel([&]
+        { bs2b->cross_feed(left.data(), right.data(), NumSamples); })};
+        AddKernelResult("post"sv, "bs2b"sv, ""sv, {}, ns, NumSamples);
+    }
+
+    auto bformat = std::vector<FloatBufferLine>(3);
+    for(auto &line : bformat)
+        FillNoise(line);
+    const std::array<const float*,3> inputs{bformat[0].data(), bformat[1].data(),
+        bformat[2].data()};
+
+    auto run_uhj = [&](std::string_view name, UhjEncoderBase &encoder)
+    {
+        if(!Selected("post"sv, name))
+            return;
+        const double ns{TimeKernel([&]
+        { encoder.encode(left.data(), right.data(), inputs, NumSamples); })};
+        AddKernelResult("post"sv, name, ""sv, {}, ns, NumSamples);
+    };
+    run_uhj("uhj_encode_iir"sv, *std::make_unique<UhjEncoderIIR>());
+    run_uhj("uhj_encode_fir256"sv, *std::make_unique<UhjEncoder<UhjLength256>>());
+    run_uhj("uhj_encode_fir512"sv, *std::make_unique<UhjEncoder<UhjLength512>>());
+}
+
+
+LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDeviceSOFT;
+LPALCISRENDERFORMATSUPPORTEDSOFT alcIsRenderFormatSupportedSOFT;
+LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT;
+LPALCRENDERSAMPLESPLANARSOFT alcRenderSamplesPlanarSOFT;
+LPALCGETINTEGER64VSOFT alcGetInteger64vSOFT;
+
+struct DeviceCloser {
+    void operator()(ALCdevice *device) { alcCloseDevice(device); }
+};
+using DevicePtr = std::unique_ptr<ALCdevice,DeviceCloser>;
+
+struct ContextDestroyer {
+    void operator()(ALCcontext *context)
+    {
+        alcMakeContextCurrent(nullptr);
+        alcDestroyContext(context);
+    }
+};
+using ContextPtr = std::unique_ptr<ALCcontext,ContextDestroyer>;
+
+
+struct LoopbackSetup {
+    std::string_view name;
+    ALCenum channels;
+    ALCenum outputMode;
+    bool hrtf;
+};
+
+/* How the loopback device is rendered with. */
+struct RenderMode {
+    bool planar{false};
+    /* The device's mixing block size, or 0 for the default. */
+    ALCint mixBlockSize{0};
+};
+
+struct EffectSetup {
+    std::string_view name;
+    ALenum type;
+    /* An optional integer property to set on the effect. */
+    ALenum param{AL_NONE};
+    ALint value{0};
+};
+
+/* Prints the mixer's timing statistics for each stage of the last loopback
+ * case.
+ */
+void PrintProfile(ALCdevice *device)
+{
+    static constexpr std::array StageNames{"param updates", "voices", "effects",
+        "post-process", "limiter", "distance comp", "dither", "write", "total"};
+    static constexpr size_t StatCount{5};
+
+    ALCint numstages{};
+    alcGetIntegerv(device, ALC_MIXER_PROFILE_NUM_STAGES_SOFT, 1, &numstages);
+    if(numstages <= 0 || static_cast<uint>(numstages) > StageNames.size())
+        return;
+    auto stats = std::vector<ALCint64SOFT>(static_cast<uint>(numstages) * StatCount);
+    alcGetInteger64vSOFT(device, ALC_MIXER_PROFILE_STATS_SOFT,
+        static_cast<ALCsizei>(stats.size()), stats.data());
+
+    fprintf(stderr, "    %-14s %10s %10s %10s %10s %10s\n", "stage", "count", "min(us)",
+        "avg(us)", "p99(us)", "max(us)");
+    for(size_t i{0};i < static_cast<uint>(numstages);++i)
+    {
+        const auto stage = al::span{stats}.subspan(i*StatCount, StatCount);
+        if(stage[0] == 0) continue;
+        fprintf(stderr, "    %-14s %10lld %10.2f %10.2f %10.2f %10.2f\n", StageNames[i],
+            static_cast<long long>(stage[0]), static_cast<double>(stage[1])/1000.0,
+            static_cast<double>(stage[2])/1000.0, static_cast<double>(stage[3])/1000.0,
+            static_cast<double>(stage[4])/1000.0);
+    }
+}
+
+/* Creates a loopback device and context for the given setup, then renders a
+ * number of playing voices (optionally fed through an effect) and records the
+ * time taken.
+ */
+void RunLoopback(std::string_view suite, std::string_view name, const LoopbackSetup &setup,
+    const EffectSetup *effect, uint numvoices, const RenderMode &mode={})
+{
+    DevicePtr device{alcLoopbackOpenDeviceSOFT(nullptr)};
+    if(!device)
+    {
+        fprintf(stderr, "  %.*s/%.*s: failed to open loopback device\n", al::sizei(suite),
+            suite.data(), al::sizei(name), name.data());
+        return;
+    }
+    if(!alcIsRenderFormatSupportedSOFT(device.get(), BenchRate, setup.channels, ALC_FLOAT_SOFT))
+    {
+        fprintf(stderr, "  %.*s/%.*s: render format not supported\n", al::sizei(suite),
+            suite.data(), al::sizei(name), name.data());
+        return;
+    }
+
+    const std::array<ALCint,17> attrs{
+        ALC_FREQUENCY, static_cast<ALCint>(BenchRate),
+        ALC_FORMAT_CHANNELS_SOFT, setup.channels,
+        ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+        ALC_OUTPUT_MODE_SOFT, setup.outputMode,
+        ALC_HRTF_SOFT, setup.hrtf ? ALC_TRUE : ALC_FALSE,
+        ALC_MONO_SOURCES, static_cast<ALCint>(numvoices),
+        ALC_MIX_BLOCK_SIZE_SOFT, mode.mixBlockSize,
+        ALC_MIXER_PROFILING_SOFT, gOptions.profile ? ALC_TRUE : ALC_FALSE,
+        0};
+    ContextPtr context{alcCreateContext(device.get(), attrs.data())};
+    if(!context || !alcMakeContextCurrent(context.get()))
+    {
+        fprintf(stderr, "  %.*s/%.*s: failed to create context\n", al::sizei(suite),
+            suite.data(), al::sizei(name), name.data());
+        return;
+    }
+
+    if(setup.hrtf)
+    {
+        ALCint status{};
+        alcGetIntegerv(device.get(), ALC_HRTF_STATUS_SOFT, 1, &status);
+        if(status != ALC_HRTF_ENABLED_SOFT)
+        {
+            fprintf(stderr, "  %.*s/%.*s: HRTF unavailable\n", al::sizei(suite), suite.data(),
+                al::sizei(name), name.data());
+            return;
+        }
+    }
+
+    /* One second of a sine tone, looped, which the sources play at different
+     * pitches and positions so they all get resampled and panned.
+     */
+    auto tone = std::vector<float>(BenchRate);
+    for(size_t i{0};i < tone.size();++i)
+        tone[i] = static_cast<float>(std::sin(al::numbers::pi * 2.0 * 440.0
+            * static_cast<double>(i) / BenchRate)) * 0.5f;
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, tone.data(),
+        static_cast<ALsizei>(tone.size()*sizeof(float)), static_cast<ALsizei>(BenchRate));
+
+    ALuint effectid{}, slot{};
+    if(effect)
+    {
+        alGenEffects(1, &effectid);
+        alEffecti(effectid, AL_EFFECT_TYPE, effect->type);
+        if(effect->param != AL_NONE)
+            alEffecti(effectid, effect->param, effect->value);
+        alGenAuxiliaryEffectSlots(1, &slot);
+        alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effectid));
+    }
+
+    auto sources = std::vector<ALuint>(numvoices);
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    for(size_t i{0};i < sources.size();++i)
+    {
+        const ALuint source{sources[i]};
+        const auto angle = static_cast<float>(al::numbers::pi * 2.0 * static_cast<double>(i)
+            / static_cast<double>(sources.size()));
+        alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
+        alSourcei(source, AL_LOOPING, AL_TRUE);
+        alSourcef(source, AL_PITCH, 0.75f + static_cast<float>(i%8)*0.125f);
+        alSource3f(source, AL_POSITION, std::sin(angle), 0.0f, -std::cos(angle));
+        if(effect)
+            alSource3i(source, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0,
+                AL_FILTER_NULL);
+    }
+    alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+
+    if(const ALenum err{alGetError()}; err != AL_NO_ERROR)
+        fprintf(stderr, "  %.*s/%.*s: AL error 0x%04x during setup\n", al::sizei(suite),
+            suite.data(), al::sizei(name), name.data(), err);
+
+    ALCint numchans{};
+    switch(setup.channels)
+    {
+    case ALC_MONO_SOFT: numchans = 1; break;
+    case ALC_STEREO_SOFT: numchans = 2; break;
+    case ALC_QUAD_SOFT: numchans = 4; break;
+    case ALC_5POINT1_SOFT: numchans = 6; break;
+    case ALC_6POINT1_SOFT: numchans = 7; break;
+    case ALC_7POINT1_SOFT: numchans = 8; break;
+    }
+    /* A mixing block can't be larger than what's rendered with each call, so
+     * the chunk size grows with larger blocks.
+     */
+    ALCint mixblock{};
+    alcGetIntegerv(device.get(), ALC_MIX_BLOCK_SIZE_SOFT, 1, &mixblock);
+    const ALCsizei chunksize{std::max(ALCsizei{1024}, mixblock)};
+    auto output = std::vector<float>(static_cast<uint>(chunksize) * static_cast<uint>(numchans));
+    auto planes = std::vector<ALCvoid*>(static_cast<uint>(numchans));
+    for(size_t c{0};c < planes.size();++c)
+        planes[c] = &output[c * static_cast<uint>(chunksize)];
+
+    auto render_chunk = [&device,&mode,&output,&planes,chunksize]
+    {
+        if(mode.planar)
+            alcRenderSamplesPlanarSOFT(device.get(), planes.data(), chunksize);
+        else
+            alcRenderSamplesSOFT(device.get(), output.data(), chunksize);
+    };
+
+    /* Render a bit first, to get past the initial fade-in and allocations. */
+    for(uint i{0};i < BenchRate/10;i += static_cast<uint>(chunksize))
+        render_chunk();
+
+    const uint total{gOptions.renderSeconds * BenchRate};
+    uint rendered{0};
+    const auto start = clock_type::now();
+    while(rendered < total)
+    {
+        render_chunk();
+        rendered += static_cast<uint>(chunksize);
+    }
+    const auto elapsed = duration_cast<nanoseconds>(clock_type::now() - start);
+
+    alSourceStopv(static_cast<ALsizei>(sources.size()), sources.data());
+    alDeleteSources(static_cast<ALsizei>(sources.size()), sources.data());
+    if(effect)
+    {
+        alDeleteAuxiliaryEffectSlots(1, &slot);
+        alDeleteEffects(1, &effectid);
+    }
+    alDeleteBuffers(1, &buffer);
+
+    const auto ns = static_cast<double>(elapsed.count());
+    const double nsperframe{ns / rendered};
+    const double realtime{static_cast<double>(rendered) / BenchRate / (ns / 1e9)};
+    fprintf(stderr, "  %.*s/%.*s: voices=%u, block=%d - %.1f ns/frame, %.1fx realtime\n",
+        al::sizei(suite), suite.data(), al::sizei(name), name.data(), numvoices, mixblock,
+        nsperframe, realtime);
+    if(gOptions.profile)
+        PrintProfile(device.get());
+
+    gResults.emplace_back(Result{suite, name, {}, {{"voices"sv, static_cast<double>(numvoices)},
+        {"mix_block"sv, static_cast<double>(mixblock)}}, nsperframe, realtime});
+}
+
+void BenchLoopback()
+{
+    static constexpr LoopbackSetup stereo{"stereo"sv, ALC_STEREO_SOFT, ALC_STEREO_BASIC_SOFT,
+        false};
+    static constexpr std::array postmodes{
+        stereo,
+        LoopbackSetup{"uhj"sv, ALC_STEREO_SOFT, ALC_STEREO_UHJ_SOFT, false},
+        LoopbackSetup{"hrtf"sv, ALC_STEREO_SOFT, ALC_STEREO_HRTF_SOFT, true},
+        LoopbackSetup{"ambidec_5.1"sv, ALC_5POINT1_SOFT, ALC_SURROUND_5_1_SOFT, false},
+        LoopbackSetup{"ambidec_7.1"sv, ALC_7POINT1_SOFT, ALC_SURROUND_7_1_SOFT, false},
+    };
+    static constexpr std::array effects{
+        EffectSetup{"reverb"sv, AL_EFFECT_REVERB},
+        EffectSetup{"eaxreverb"sv, AL_EFFECT_EAXREVERB},
+        EffectSetup{"chorus"sv, AL_EFFECT_CHORUS},
+        EffectSetup{"flanger"sv, AL_EFFECT_FLANGER},
+        EffectSetup{"distortion"sv, AL_EFFECT_DISTORTION},
+        EffectSetup{"echo"sv, AL_EFFECT_ECHO},
+        EffectSetup{"equalizer"sv, AL_EFFECT_EQUALIZER},
+        EffectSetup{"compressor"sv, AL_EFFECT_COMPRESSOR},
+        EffectSetup{"frequency_shifter"sv, AL_EFFECT_FREQUENCY_SHIFTER},
+        EffectSetup{"vocal_morpher"sv, AL_EFFECT_VOCAL_MORPHER},
+        EffectSetup{"pitch_shifter"sv, AL_EFFECT_PITCH_SHIFTER},
+        EffectSetup{"pitch_shifter_medium"sv, AL_EFFECT_PITCH_SHIFTER,
+            AL_PITCH_SHIFTER_QUALITY_SOFT, AL_PITCH_SHIFTER_QUALITY_MEDIUM_SOFT},
+        EffectSetup{"pitch_shifter_low"sv, AL_EFFECT_PITCH_SHIFTER,
+            AL_PITCH_SHIFTER_QUALITY_SOFT, AL_PITCH_SHIFTER_QUALITY_LOW_SOFT},
+        EffectSetup{"ring_modulator"sv, AL_EFFECT_RING_MODULATOR},
+        EffectSetup{"autowah"sv, AL_EFFECT_AUTOWAH},
+    };
+
+    struct BlockSetup {
+        std::string_view name;
+        ALCint size;
+    };
+    static constexpr std::array blocksizes{
+        BlockSetup{"64"sv, 64}, BlockSetup{"128"sv, 128}, BlockSetup{"256"sv, 256},
+        BlockSetup{"512"sv, 512}, BlockSetup{"1024"sv, 1024}, BlockSetup{"2048"sv, 2048},
+        BlockSetup{"4096"sv, 4096},
+    };
+
+    if(!alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"))
+    {
+        fprintf(stderr, "ALC_SOFT_loopback not supported, skipping loopback tests\n");
+        return;
+    }
+
+#define LOAD_PROC(T, x) ((x) = reinterpret_cast<T>(alcGetProcAddress(nullptr, #x)))
+    LOAD_PROC(LPALCLOOPBACKOPENDEVICESOFT, alcLoopbackOpenDeviceSOFT);
+    LOAD_PROC(LPALCISRENDERFORMATSUPPORTEDSOFT, alcIsRenderFormatSupportedSOFT);
+    LOAD_PROC(LPALCRENDERSAMPLESSOFT, alcRenderSamplesSOFT);
+    LOAD_PROC(LPALCRENDERSAMPLESPLANARSOFT, alcRenderSamplesPlanarSOFT);
+    LOAD_PROC(LPALCGETINTEGER64VSOFT, alcGetInteger64vSOFT);
+#undef LOAD_PROC
+
+    /* Scale the voice count for the mixing tests, and use the smallest one for
+     * effects and post-processing so the voices don't dominate the time.
+     */
+    if(Selected("render"sv, "voices"sv))
+    {
+        for(const uint voices : gOptions.voiceCounts)
+            RunLoopback("render"sv, "voices"sv, stereo, nullptr, voices);
+    }
+    if(Selected("render"sv, "planar"sv))
+    {
+        for(const uint voices : gOptions.voiceCounts)
+            RunLoopback("render"sv, "planar"sv, stereo, nullptr, voices, RenderMode{true});
+    }
+
+    const uint fxvoices{*std::min_element(gOptions.voiceCounts.cbegin(),
+        gOptions.voiceCounts.cend())};
+    for(const auto &block : blocksizes)
+    {
+        if(Selected("block"sv, block.name))
+            RunLoopback("block"sv, block.name, stereo, nullptr, fxvoices,
+                RenderMode{true, block.size});
+    }
+    for(const auto &effect : effects)
+    {
+        if(Selected("effect"sv, effect.name))
+            RunLoopback("effect"sv, effect.name, stereo, &effect, fxvoices);
+    }
+    for(const auto &setup : postmodes)
+    {
+        if(Selected("post"sv, setup.name))
+            RunLoopback("post"sv, setup.name, setup, nullptr, fxvoices);
+    }
+}
+
+
+void WriteJsonString(FILE *f, std::string_view str)
+{
+    fputc('"', f);
+    for(const char c : str)
+    {
+        if(c == '"' || c == '\\')
+            fprintf(f, "\\%c", c);
+        else if(static_cast<unsigned char>(c) < 0x20)
+            fprintf(f, "\\u%04x", static_cast<unsigned char>(c));
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+void WriteJson(FILE *f)
+{
+    const auto cpuinfo = GetCPUInfo();
+
+    fprintf(f, "{\n  \"version\": 1,\n  \"cpu\": ");
+    WriteJsonString(f, cpuinfo ? cpuinfo->mName : std::string{});
+    fprintf(f, ",\n  \"vendor\": ");
+    WriteJsonString(f, cpuinfo ? cpuinfo->mVendor : std::string{});
+    fprintf(f, ",\n  \"sample_rate\": %u,\n  \"results\": [", BenchRate);
+
+    const char *sep{"\n"};
+    for(const auto &result : gResults)
+    {
+        fprintf(f, "%s    {\"suite\": ", sep);
+        WriteJsonString(f, result.suite);
+        fprintf(f, ", \"case\": ");
+        WriteJsonString(f, result.name);
+        if(!result.simd.empty())
+        {
+            fprintf(f, ", \"simd\": ");
+            WriteJsonString(f, result.simd);
+        }
+        fprintf(f, ", \"params\": {");
+        const char *psep{""};
+        for(const auto &param : result.params)
+        {
+            fprintf(f, "%s", psep);
+            WriteJsonString(f, param.name);
+            fprintf(f, ": %g", param.value);
+            psep = ", ";
+        }
+        fprintf(f, "}, \"ns_per_sample\": %.4f", result.nsPerSample);
+        if(result.realtime > 0.0)
+            fprintf(f, ", \"realtime_factor\": %.2f", result.realtime);
+        fprintf(f, "}");
+        sep = ",\n";
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+
+auto ParseUIntList(std::string_view str) -> std::vector<uint>
+{
+    std::vector<uint> ret;
+    while(!str.empty())
+    {
+        const auto comma = str.find(',');
+        const auto item = std::string{str.substr(0, comma)};
+        char *end{};
+        const auto value = std::strtoul(item.c_str(), &end, 10);
+        if(end == item.c_str() || *end != '\0' || value == 0 || value > 4096)
+            return {};
+        ret.emplace_back(static_cast<uint>(value));
+        str = (comma == std::string_view::npos) ? std::string_view{} : str.substr(comma+1);
+    }
+    return ret;
+}
+
+int main(al::span<std::string_view> args)
+{
+    auto print_usage = [&args]()
+    {
+        printf("Usage: %.*s [options]\n\n"
+            "  Options:\n"
+            "    -t, --time <ms>         Time to run each kernel case (default 100)\n"
+            "    -s, --seconds <n>       Seconds of audio to render for each loopback case\n"
+            "                            (default 4)\n"
+            "    -v, --voices <n,...>    Comma-separated voice counts for the loopback mixing\n"
+            "                            cases (default 16,64,256)\n"
+            "    -f, --filter <text>     Only run cases whose suite/case name contains the\n"
+            "                            text (may be given multiple times)\n"
+            "    -o, --output <file>     Write the JSON results to the file instead of stdout\n"
+            "    -p, --profile           Print the mixer's per-stage timings for each loopback\n"
+            "                            case\n"
+            "\n"
+            "The suites are resample, mix, hrtf, filter, post, render, block, and effect.\n"
+            "Progress is printed to stderr.\n",
+            al::sizei(args[0]), args[0].data());
+    };
+
+    for(size_t i{1};i < args.size();++i)
+    {
+        const std::string_view arg{args[i]};
+        if(arg == "-h"sv || arg == "--help"sv)
+        {
+            print_usage();
+            return 0;
+        }
+        if(arg == "-p"sv || arg == "--profile"sv)
+        {
+            gOptions.profile = true;
+            continue;
+        }
+
+        if(i+1 >= args.size())
+        {
+            fprintf(stderr, "Invalid or incomplete option: %.*s\n", al::sizei(arg), arg.data());
+            print_usage();
+            return 1;
+        }
+        const std::string value{args[++i]};
+        if(arg == "-t"sv || arg == "--time"sv)
+        {
+            const double ms{std::strtod(value.c_str(), nullptr)};
+            if(!(ms > 0.0))
+            {
+                fprintf(stderr, "Invalid time: %s\n", value.c_str());
+                return 1;
+            }
+            gOptions.kernelTime = ms / 1000.0;
+        }
+        else if(arg == "-s"sv || arg == "--seconds"sv)
+        {
+            const auto secs = std::strtoul(value.c_str(), nullptr, 10);
+            if(secs < 1 || secs > 3600)
+            {
+                fprintf(stderr, "Invalid seconds: %s\n", value.c_str());
+                return 1;
+            }
+            gOptions.renderSeconds = static_cast<uint>(secs);
+        }
+        else if(arg == "-v"sv || arg == "--voices"sv)
+        {
+            gOptions.voiceCounts = ParseUIntList(value);
+            if(gOptions.voiceCounts.empty())
+            {
+                fprintf(stderr, "Invalid voice count list: %s\n", value.c_str());
+                return 1;
+            }
+        }
+        else if(arg == "-f"sv || arg == "--filter"sv)
+            gOptions.filters.emplace_back(value);
+        else if(arg == "-o"sv || arg == "--output"sv)
+            gOptions.output = value;
+        else
+        {
+            fprintf(stderr, "Invalid option: %.*s\n", al::sizei(arg), arg.data());
+            print_usage();
+            return 1;
+        }
+    }
+
+    FILE *outfile{stdout};
+    if(!gOptions.output.empty())
+    {
+        outfile = fopen(gOptions.output.c_str(), "w");
+        if(!outfile)
+        {
+            fprintf(stderr, "Failed to open %s for writing\n", gOptions.output.c_str());
+            return 1;
+        }
+    }
+
+    const auto levels = GetCpuLevels();
+    fprintf(stderr, "Running kernel benchmarks...\n");
+    BenchResamplers(levels);
+    BenchMixers(levels);
+    BenchHrtf(levels);
+    BenchFilters();
+    BenchHilbert();
+    BenchPostProcess();
+
+    fprintf(stderr, "Running loopback benchmarks...\n");
+    BenchLoopback();
+
+    WriteJson(outfile);
+    if(outfile != stdout)
+        fclose(outfile);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    assert(argc >= 0);
+    auto args = std::vector<std::string_view>(static_cast<unsigned int>(argc));
+    std::copy_n(argv, args.size(), args.begin());
+    return main(al::span{args});
+}